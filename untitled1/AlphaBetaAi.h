@@ -0,0 +1,246 @@
+#ifndef ALPHABETAAI_H
+#define ALPHABETAAI_H
+
+#include <vector>
+#include <chrono>
+#include <climits>
+#include <optional>
+#include <algorithm>
+#include "GameState.h"
+#include "TranspositionTable.h"
+
+/*
+ * IA de búsqueda: negamax con poda alfa-beta sobre GameState, con profundización iterativa
+ * (profundidad 1, 2, 3, ... hasta agotar el tiempo) y orden de jugadas: primero la mejor de la
+ * iteración anterior, después los disparos que matan o hacen más daño, las jugadas "killer" que
+ * podaron en la misma profundidad y al final los movimientos que acercan al enemigo.
+ * Si se acaba el tiempo a mitad de una iteración se devuelve la de la última iteración completa.
+ *
+ * Las posiciones ya buscadas quedan en una tabla de transposición (clave: Zobrist del estado y del
+ * mapa), que se conserva entre búsquedas: una posición repetida a igual o menor profundidad no se
+ * vuelve a buscar ni a evaluar, y su mejor jugada se prueba primero. Las reglas también se
+ * conservan mientras el mapa sea el mismo y no cambien sus obstáculos, con los rebotes que ya
+ * calcularon.
+ */
+class AlphaBetaAi {
+public:
+    struct Options {
+        int maxDepth = 16;
+        int timeBudgetMs = 100;
+        int moveRadius = GameStateRules::DEFAULT_MOVE_RADIUS;
+        int tableSizeLog2 = TranspositionTable::DEFAULT_SIZE_LOG2;
+    };
+
+    struct Result {
+        AiMove move;
+        int score = 0;
+        int depth = 0;        // Última profundidad completa
+        long long nodes = 0;
+        long long tableHits = 0; // Nodos resueltos o acotados con la tabla
+        double seconds = 0.0;
+    };
+
+    static const int WIN_SCORE = 1000000;
+
+    AlphaBetaAi() : table(options.tableSizeLog2) {}
+    explicit AlphaBetaAi(const Options& options) : options(options), table(options.tableSizeLog2) {}
+
+    /*
+     * Vaciar la tabla (por ejemplo al empezar otra partida). También se olvidan las reglas: el mapa
+     * de otra partida puede estar en la misma dirección y con la misma versión de obstáculos.
+     */
+    void clearTable() {
+        table.clear();
+        cachedRules.reset();
+        rulesMap = nullptr;
+    }
+
+    Result search(const Map& gameMap, const GameState& root) {
+        GameStateRules& rules = rulesFor(gameMap);
+        this->rules = &rules;
+        rules.bind(root);
+        start = std::chrono::steady_clock::now();
+        deadline = start + std::chrono::milliseconds(options.timeBudgetMs);
+        nodes = 0;
+        tableHits = 0;
+        aborted = false;
+        std::fill(&killers[0][0], &killers[0][0] + MAX_PLY * 2, AiMove());
+
+        Result result;
+        std::vector<AiMove> rootMoves;
+        rules.generate(root, rootMoves);
+        result.move = rootMoves.front();
+
+        for (int depth = 1; depth <= options.maxDepth; ++depth) {
+            int alpha = -INT_MAX;
+            AiMove best = rootMoves.front();
+            for (const AiMove& move : rootMoves) {
+                GameState child = root;
+                rules.apply(child, move);
+                int score = -negamax(child, depth - 1, -INT_MAX, -alpha, 1);
+                rules.undo(root, child);
+                if (aborted) break;
+                if (score > alpha) {
+                    alpha = score;
+                    best = move;
+                }
+            }
+            if (aborted) break;
+            result.move = best;
+            result.score = alpha;
+            result.depth = depth;
+            // La mejor jugada va primero en la siguiente iteración
+            std::stable_partition(rootMoves.begin(), rootMoves.end(), [&](const AiMove& move) { return move == best; });
+            if (alpha >= WIN_SCORE - MAX_PLY || alpha <= -WIN_SCORE + MAX_PLY) break; // Resultado seguro
+        }
+
+        result.nodes = nodes;
+        result.tableHits = tableHits;
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        this->rules = nullptr;
+        return result;
+    }
+
+private:
+    static const int MAX_PLY = 64;
+    static const int TIME_CHECK_NODES = 1024;
+
+    Options options;
+    TranspositionTable table;
+    GameStateRules* rules = nullptr;
+    std::optional<GameStateRules> cachedRules;
+    const Map* rulesMap = nullptr;
+    std::uint64_t rulesObstacleVersion = 0;
+    int rulesCells = 0;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::time_point deadline;
+    long long nodes = 0;
+    long long tableHits = 0;
+    bool aborted = false;
+    AiMove killers[MAX_PLY][2];
+    std::vector<AiMove> moveBuffers[MAX_PLY];
+    std::vector<int> orderBuffers[MAX_PLY];
+
+    GameStateRules& rulesFor(const Map& gameMap) {
+        if (!cachedRules || rulesMap != &gameMap || rulesObstacleVersion != gameMap.getObstacleVersion()
+            || rulesCells != gameMap.getNumCells()) {
+            cachedRules.emplace(gameMap, options.moveRadius);
+            rulesMap = &gameMap;
+            rulesObstacleVersion = gameMap.getObstacleVersion();
+            rulesCells = gameMap.getNumCells();
+        }
+        return *cachedRules;
+    }
+
+    int negamax(const GameState& state, int depth, int alpha, int beta, int ply) {
+        if ((++nodes % TIME_CHECK_NODES) == 0 && std::chrono::steady_clock::now() >= deadline) aborted = true;
+        if (aborted) return 0;
+        if (state.aliveCount(state.currentPlayer) == 0) return -WIN_SCORE + ply; // Ganar antes vale más
+        if (state.aliveCount(1 - state.currentPlayer) == 0) return WIN_SCORE - ply;
+        depth = std::max(0, std::min(depth, MAX_PLY - 1 - ply));
+
+        std::uint64_t key = rules->positionKey(state);
+        TableEntry entry;
+        const AiMove* tableMove = nullptr;
+        if (table.probe(key, entry)) {
+            if (entry.hasMove) tableMove = &entry.move;
+            if (entry.depth >= depth) {
+                int score = fromTable(entry.score, ply);
+                if (entry.bound == BoundType::Exact
+                    || (entry.bound == BoundType::Lower && score >= beta)
+                    || (entry.bound == BoundType::Upper && score <= alpha)) {
+                    ++tableHits;
+                    return score;
+                }
+            }
+        }
+        if (depth == 0) {
+            int score = rules->evaluate(state);
+            table.store(key, {toTable(score, ply), 0, BoundType::Exact, false, AiMove()});
+            return score;
+        }
+
+        std::vector<AiMove>& moves = moveBuffers[ply];
+        rules->generate(state, moves);
+        orderMoves(state, moves, ply, tableMove);
+
+        int alphaStart = alpha;
+        int best = -INT_MAX;
+        AiMove bestMove = moves.front();
+        for (const AiMove& move : moves) {
+            GameState child = state;
+            rules->apply(child, move);
+            int score = -negamax(child, depth - 1, -beta, -alpha, ply + 1);
+            rules->undo(state, child);
+            if (aborted) return 0;
+            if (score > best) {
+                best = score;
+                bestMove = move;
+            }
+            if (score > alpha) alpha = score;
+            if (alpha >= beta) {
+                if (move.kind != AiMoveKind::Fire && !(move == killers[ply][0])) {
+                    killers[ply][1] = killers[ply][0];
+                    killers[ply][0] = move;
+                }
+                break;
+            }
+        }
+        BoundType bound = best <= alphaStart ? BoundType::Upper : (best >= beta ? BoundType::Lower : BoundType::Exact);
+        table.store(key, {toTable(best, ply), depth, bound, true, bestMove});
+        return best;
+    }
+
+    // Las victorias se guardan contadas desde el nodo y no desde la raíz, para que valgan en cualquier ply
+    static int toTable(int score, int ply) {
+        if (score >= WIN_SCORE - MAX_PLY) return score + ply;
+        if (score <= -WIN_SCORE + MAX_PLY) return score - ply;
+        return score;
+    }
+
+    static int fromTable(int score, int ply) {
+        if (score >= WIN_SCORE - MAX_PLY) return score - ply;
+        if (score <= -WIN_SCORE + MAX_PLY) return score + ply;
+        return score;
+    }
+
+    void orderMoves(const GameState& state, std::vector<AiMove>& moves, int ply, const AiMove* tableMove) {
+        std::vector<int>& keys = orderBuffers[ply];
+        keys.resize(moves.size());
+        for (std::size_t k = 0; k < moves.size(); ++k) {
+            const AiMove& move = moves[k];
+            int key = 0;
+            if (tableMove && move == *tableMove) {
+                key = 40000;
+            } else if (move.kind == AiMoveKind::Fire) {
+                int damage = Projectile::of(move.projectile).damage;
+                const GameState::TankSlot* target = nullptr;
+                for (int j = 0; j < state.numTanks; ++j) {
+                    if (state.tanks[j].row == move.row && state.tanks[j].col == move.col && state.tanks[j].health > 0) target = &state.tanks[j];
+                }
+                key = 20000 + damage + (target && target->health <= damage ? 10000 : 0);
+            } else if (move == killers[ply][0] || move == killers[ply][1]) {
+                key = 10000;
+            } else if (move.kind == AiMoveKind::Move) {
+                // Más arriba cuanto más cerca quede del enemigo más próximo
+                key = 1000 - GameStateRules::nearestEnemyDistance(state, state.tanks[move.tank].team, move.row, move.col);
+            }
+            keys[k] = key;
+        }
+        // Inserción: las listas son cortas y casi siempre ya vienen con los disparos adelante
+        for (std::size_t i = 1; i < moves.size(); ++i) {
+            AiMove move = moves[i];
+            int key = keys[i];
+            std::size_t j = i;
+            while (j > 0 && keys[j - 1] < key) {
+                moves[j] = moves[j - 1];
+                keys[j] = keys[j - 1];
+                --j;
+            }
+            moves[j] = move;
+            keys[j] = key;
+        }
+    }
+};
+
+#endif // ALPHABETAAI_H
@@ -0,0 +1,110 @@
+#ifndef ASYNCPATHSERVICE_H
+#define ASYNCPATHSERVICE_H
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <QObject>
+#include <QThreadPool>
+#include <QPoint>
+#include "Graph.h"
+#include "Pathfinding.h"
+#include "HierarchicalPathfinding.h"
+#include "IncrementalPathfinding.h"
+#include "GameSimulation.h"
+
+/*
+ * Búsquedas de caminos fuera del hilo de la ventana. Cada pedido corre en un QThreadPool sobre
+ * una copia del mapa (se copia una vez por versión de obstáculos: la ocupación no cambia los
+ * caminos, salvo para D* Lite, que esquiva tanques y recibe una copia por versión del mapa) con el
+ * workspace del hilo del pool, y el resultado vuelve al hilo de `context` como llamada encolada.
+ * Así la ventana nunca espera a una búsqueda.
+ *
+ * Un pedido nuevo cancela los anteriores: su bandera se prende, la búsqueda la ve en el próximo
+ * control del workspace y termina, y aunque el resultado ya estuviera encolado no se entrega.
+ */
+class AsyncPathService {
+public:
+    // Recibe el número de pedido y el camino (vacío si no hay)
+    using Callback = std::function<void(std::uint64_t, std::vector<QPoint>)>;
+
+    explicit AsyncPathService(QObject *context, int maxThreads = 0) : context(context) {
+        if (maxThreads > 0) pool.setMaxThreadCount(maxThreads);
+    }
+
+    ~AsyncPathService() {
+        cancelAll();
+        pool.waitForDone();
+    }
+
+    /*
+     * Buscar con `algorithm` de (startRow, startCol) a (targetRow, targetCol) en el estado actual
+     * de `gameMap`. Devuelve el número de pedido; `done` se llama en el hilo de `context`.
+     */
+    std::uint64_t request(const Map& gameMap, PathAlgorithm algorithm, int startRow, int startCol,
+                          int targetRow, int targetCol, Callback done) {
+        cancelAll();
+        std::uint64_t ticket = ++lastTicket;
+        auto cancelled = std::make_shared<std::atomic<bool>>(false);
+        current = cancelled;
+        std::shared_ptr<const Map> snapshot = snapshotOf(gameMap, algorithm == PathAlgorithm::Incremental);
+        QObject *receiver = context;
+        pool.start([=]() {
+            PathfindingWorkspace& workspace = Pathfinding::defaultWorkspace();
+            workspace.setCancelFlag(cancelled.get());
+            std::vector<QPoint> path;
+            if (algorithm == PathAlgorithm::Hierarchical) {
+                // Uno por hilo del pool; se pone al día con el registro de la copia (no mira la bandera)
+                thread_local HierarchicalPathfinder hierarchical;
+                path = hierarchical.findPath(*snapshot, startRow, startCol, targetRow, targetCol);
+            } else if (algorithm == PathAlgorithm::Incremental) {
+                // Uno por hilo del pool: repara su búsqueda cuando se repite el destino
+                thread_local IncrementalPlanner incremental;
+                path = incremental.plan(*snapshot, 0, startRow, startCol, targetRow, targetCol);
+            } else if (algorithm == PathAlgorithm::Bfs) {
+                path = Pathfinding::bfsPath(*snapshot, workspace, startRow, startCol, targetRow, targetCol);
+            } else {
+                path = Pathfinding::astarPath(*snapshot, workspace, startRow, startCol, targetRow, targetCol);
+            }
+            workspace.setCancelFlag(nullptr);
+            if (cancelled->load()) return;
+            QMetaObject::invokeMethod(receiver, [=, path = std::move(path)]() mutable {
+                if (!cancelled->load()) done(ticket, std::move(path));
+            }, Qt::QueuedConnection);
+        });
+        return ticket;
+    }
+
+    // Cancelar el pedido en curso (si lo hay)
+    void cancelAll() {
+        if (current) current->store(true);
+        current.reset();
+    }
+
+    std::uint64_t getLastTicket() const { return lastTicket; }
+
+private:
+    QObject *context;
+    QThreadPool pool;
+    std::shared_ptr<std::atomic<bool>> current;
+    std::uint64_t lastTicket = 0;
+    std::shared_ptr<const Map> snapshot;
+    std::uint64_t snapshotVersion = 0;
+    std::uint64_t snapshotFullVersion = 0;
+
+    // Con `withOccupancy` la copia tiene que estar al día también con los tanques
+    std::shared_ptr<const Map> snapshotOf(const Map& gameMap, bool withOccupancy) {
+        if (!snapshot || snapshotVersion != gameMap.getObstacleVersion()
+            || (withOccupancy && snapshotFullVersion != gameMap.getVersion())
+            || snapshot->getNumRows() != gameMap.getNumRows() || snapshot->getNumCols() != gameMap.getNumCols()) {
+            snapshot = std::make_shared<const Map>(gameMap);
+            snapshotVersion = gameMap.getObstacleVersion();
+            snapshotFullVersion = gameMap.getVersion();
+        }
+        return snapshot;
+    }
+};
+
+#endif // ASYNCPATHSERVICE_H
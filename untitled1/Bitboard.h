@@ -0,0 +1,313 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include "Graph.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+/*
+ * Vista en bits del Map: un plano de obstáculos y otro de ocupación (celdas PATH).
+ * Cada fila se guarda en palabras de 64 bits con una columna de relleno a cada lado
+ * y hay una fila de relleno arriba y abajo, así que revisar los vecinos de una celda
+ * nunca necesita validar índices: el relleno siempre cuenta como bloqueado.
+ * El BFS avanza la frontera completa palabra por palabra con shifts/AND/OR.
+ */
+class MapBitboard {
+public:
+    using Plane = std::vector<std::uint64_t>;
+
+    explicit MapBitboard(const Map& gameMap) {
+        rebuild(gameMap);
+    }
+
+    // Reconstruir los planos a partir del mapa
+    void rebuild(const Map& gameMap) {
+        rows = gameMap.getNumRows();
+        cols = gameMap.getNumCols();
+        wordsPerRow = (cols + 2 + 63) / 64;
+        // Una palabra extra al inicio y al final para poder leer k - 1 y k + 1 sin validar
+        std::size_t total = static_cast<std::size_t>(rows + 2) * wordsPerRow + 2;
+        obstacles.assign(total, 0);
+        occupied.assign(total, 0);
+        freeCells.assign(total, 0);
+
+        for (int i = 0; i < rows; ++i) {
+            for (int j = 0; j < cols; ++j) {
+                int state = gameMap.cellAt(i, j);
+                if (state == Map::OBSTACLE) {
+                    setBit(obstacles, i, j);
+                } else {
+                    setBit(freeCells, i, j);
+                    if (state == Map::PATH) {
+                        setBit(occupied, i, j);
+                    }
+                }
+            }
+        }
+    }
+
+    // Actualizar una sola celda cuando cambia en el mapa
+    void updateCell(int row, int col, int state) {
+        if (!isValidIndex(row, col)) return;
+        clearBit(obstacles, row, col);
+        clearBit(occupied, row, col);
+        clearBit(freeCells, row, col);
+        if (state == Map::OBSTACLE) {
+            setBit(obstacles, row, col);
+        } else {
+            setBit(freeCells, row, col);
+            if (state == Map::PATH) {
+                setBit(occupied, row, col);
+            }
+        }
+    }
+
+    bool isValidIndex(int row, int col) const {
+        return row >= 0 && row < rows && col >= 0 && col < cols;
+    }
+
+    bool isObstacle(int row, int col) const {
+        return isValidIndex(row, col) && testBit(obstacles, row, col);
+    }
+
+    bool isOccupied(int row, int col) const {
+        return isValidIndex(row, col) && (testBit(obstacles, row, col) || testBit(occupied, row, col));
+    }
+
+    // Comprobar si una celda está marcada en un plano devuelto por reachable()
+    bool contains(const Plane& plane, int row, int col) const {
+        return isValidIndex(row, col) && testBit(plane, row, col);
+    }
+
+    /*
+     * Todas las celdas alcanzables desde (startRow, startCol) moviéndose en 4 direcciones.
+     * Si blockOccupied es true, las celdas con tanque (PATH) también bloquean el paso.
+     * Se hacen barridos hacia abajo y hacia arriba rellenando tramos completos de cada fila
+     * hasta que ya no aparecen celdas nuevas.
+     */
+    Plane reachable(int startRow, int startCol, bool blockOccupied = false) const {
+        Plane visited(freeCells.size(), 0);
+        if (!isValidIndex(startRow, startCol) || !testBit(freeCells, startRow, startCol)) {
+            return visited;
+        }
+
+        Plane walkable = walkablePlane(startRow, startCol, blockOccupied);
+        setBit(visited, startRow, startCol);
+        fillRow(visited, walkable, startRow);
+
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (int r = 1; r < rows; ++r) {
+                changed |= mergeRow(visited, walkable, r, r - 1);
+            }
+            for (int r = rows - 2; r >= 0; --r) {
+                changed |= mergeRow(visited, walkable, r, r + 1);
+            }
+        }
+        return visited;
+    }
+
+    // Cantidad de celdas alcanzables desde el inicio (incluyéndolo)
+    std::size_t countReachable(int startRow, int startCol, bool blockOccupied = false) const {
+        Plane visited = reachable(startRow, startCol, blockOccupied);
+        std::size_t count = 0;
+        for (std::uint64_t word : visited) {
+            count += static_cast<std::size_t>(__builtin_popcountll(word));
+        }
+        return count;
+    }
+
+    /*
+     * Distancia en pasos desde el inicio a cada celda (índice fila * cols + columna), -1 si no se alcanza.
+     * Si targetRow/targetCol son válidos, el relleno se detiene en cuanto llega al objetivo.
+     * Es un BFS por niveles donde cada nivel solo toca las palabras de la frontera y sus vecinas.
+     */
+    std::vector<int> distanceField(int startRow, int startCol, bool blockOccupied = false,
+                                   int targetRow = -1, int targetCol = -1) const {
+        std::vector<int> distance(static_cast<std::size_t>(rows) * cols, -1);
+        if (!isValidIndex(startRow, startCol) || !testBit(freeCells, startRow, startCol)) {
+            return distance;
+        }
+        distance[static_cast<std::size_t>(startRow) * cols + startCol] = 0;
+        if (startRow == targetRow && startCol == targetCol) {
+            return distance;
+        }
+        bool hasTarget = isValidIndex(targetRow, targetCol);
+
+        const std::size_t stride = static_cast<std::size_t>(wordsPerRow);
+        const std::size_t firstWord = wordIndex(0, 0);
+        const std::size_t lastWord = wordIndex(rows, 0);
+        Plane walkable = walkablePlane(startRow, startCol, blockOccupied);
+        Plane visited(freeCells.size(), 0);
+        Plane frontier(freeCells.size(), 0);
+        Plane next(freeCells.size(), 0);
+        std::vector<std::uint32_t> stamp(freeCells.size(), 0);
+
+        setBit(frontier, startRow, startCol);
+        setBit(visited, startRow, startCol);
+        std::vector<std::size_t> active = {bitWord(startRow, startCol)};
+        std::vector<std::size_t> candidates;
+        std::vector<std::size_t> nextActive;
+
+        for (std::uint32_t level = 1; !active.empty(); ++level) {
+            // Palabras que pueden recibir celdas nuevas: las de la frontera y sus 4 vecinas
+            candidates.clear();
+            for (std::size_t k : active) {
+                const std::size_t around[] = {k, k - 1, k + 1, k - stride, k + stride};
+                for (std::size_t c : around) {
+                    if (c >= firstWord && c < lastWord && stamp[c] != level) {
+                        stamp[c] = level;
+                        candidates.push_back(c);
+                    }
+                }
+            }
+
+            nextActive.clear();
+            const std::uint64_t* f = frontier.data();
+            for (std::size_t k : candidates) {
+                std::uint64_t grow = f[k] | f[k - stride] | f[k + stride]
+                                     | (f[k] << 1) | (f[k - 1] >> 63)
+                                     | (f[k] >> 1) | (f[k + 1] << 63);
+                std::uint64_t fresh = grow & walkable[k] & ~visited[k];
+                if (!fresh) continue;
+                next[k] = fresh;
+                visited[k] |= fresh;
+                nextActive.push_back(k);
+
+                int row = static_cast<int>((k - firstWord) / stride);
+                int wordInRow = static_cast<int>((k - firstWord) % stride);
+                while (fresh) {
+                    int bit = __builtin_ctzll(fresh);
+                    fresh &= fresh - 1;
+                    int col = wordInRow * 64 + bit - 1;
+                    distance[static_cast<std::size_t>(row) * cols + col] = static_cast<int>(level);
+                }
+            }
+
+            for (std::size_t k : active) {
+                frontier[k] = 0;
+            }
+            std::swap(frontier, next);
+            std::swap(active, nextActive);
+
+            if (hasTarget && testBit(frontier, targetRow, targetCol)) {
+                break;
+            }
+        }
+        return distance;
+    }
+
+    int getNumRows() const { return rows; }
+    int getNumCols() const { return cols; }
+
+private:
+    int rows = 0;
+    int cols = 0;
+    int wordsPerRow = 0;
+    Plane obstacles;
+    Plane occupied;
+    Plane freeCells;
+
+    // La fila real r vive en la fila r + 1 del tablero y la columna c en el bit c + 1
+    std::size_t wordIndex(int row, int word) const {
+        return 1 + static_cast<std::size_t>(row + 1) * wordsPerRow + word;
+    }
+
+    std::size_t bitWord(int row, int col) const { return wordIndex(row, (col + 1) >> 6); }
+    static std::uint64_t bitMask(int col) { return std::uint64_t(1) << ((col + 1) & 63); }
+
+    void setBit(Plane& plane, int row, int col) const { plane[bitWord(row, col)] |= bitMask(col); }
+    void clearBit(Plane& plane, int row, int col) const { plane[bitWord(row, col)] &= ~bitMask(col); }
+    bool testBit(const Plane& plane, int row, int col) const { return (plane[bitWord(row, col)] & bitMask(col)) != 0; }
+
+    // Plano de celdas transitables; el tanque que se mueve no se bloquea a sí mismo
+    Plane walkablePlane(int startRow, int startCol, bool blockOccupied) const {
+        Plane walkable = freeCells;
+        if (blockOccupied) {
+            for (std::size_t k = 0; k < walkable.size(); ++k) {
+                walkable[k] &= ~occupied[k];
+            }
+            setBit(walkable, startRow, startCol);
+        }
+        return walkable;
+    }
+
+    /*
+     * Pasar a la fila `row` lo visitado en la fila vecina `from` (solo donde es transitable)
+     * y rellenar los tramos de la fila. Devuelve true si la fila ganó celdas nuevas.
+     */
+    bool mergeRow(Plane& visited, const Plane& walkable, int row, int from) const {
+        std::uint64_t* dst = visited.data() + wordIndex(row, 0);
+        const std::uint64_t* src = visited.data() + wordIndex(from, 0);
+        const std::uint64_t* walk = walkable.data() + wordIndex(row, 0);
+        std::uint64_t added = 0;
+        int w = 0;
+
+#if defined(__AVX2__)
+        __m256i addedVec = _mm256_setzero_si256();
+        for (; w + 4 <= wordsPerRow; w += 4) {
+            __m256i cur = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + w));
+            __m256i seed = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + w)),
+                                            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(walk + w)));
+            addedVec = _mm256_or_si256(addedVec, _mm256_andnot_si256(cur, seed));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + w), _mm256_or_si256(cur, seed));
+        }
+        added = _mm256_testz_si256(addedVec, addedVec) ? 0 : 1;
+#endif
+        for (; w < wordsPerRow; ++w) {
+            std::uint64_t seed = src[w] & walk[w];
+            added |= seed & ~dst[w];
+            dst[w] |= seed;
+        }
+
+        if (!added) return false;
+        fillRow(visited, walkable, row);
+        return true;
+    }
+
+    /*
+     * Extender lo visitado en una fila a los tramos transitables completos que lo contienen.
+     * Relleno Kogge-Stone dentro de cada palabra (6 pasos) con acarreo entre palabras:
+     * primero hacia los bits altos y luego hacia los bajos.
+     */
+    void fillRow(Plane& visited, const Plane& walkable, int row) const {
+        std::uint64_t* v = visited.data() + wordIndex(row, 0);
+        const std::uint64_t* walk = walkable.data() + wordIndex(row, 0);
+
+        std::uint64_t carry = 0;
+        for (int w = 0; w < wordsPerRow; ++w) {
+            std::uint64_t pro = walk[w];
+            std::uint64_t gen = v[w] | (carry & pro);
+            gen |= pro & (gen << 1);  pro &= pro << 1;
+            gen |= pro & (gen << 2);  pro &= pro << 2;
+            gen |= pro & (gen << 4);  pro &= pro << 4;
+            gen |= pro & (gen << 8);  pro &= pro << 8;
+            gen |= pro & (gen << 16); pro &= pro << 16;
+            gen |= pro & (gen << 32);
+            v[w] = gen;
+            carry = (gen >> 63) & 1;
+        }
+
+        carry = 0;
+        for (int w = wordsPerRow - 1; w >= 0; --w) {
+            std::uint64_t pro = walk[w];
+            std::uint64_t gen = v[w] | (carry & pro);
+            gen |= pro & (gen >> 1);  pro &= pro >> 1;
+            gen |= pro & (gen >> 2);  pro &= pro >> 2;
+            gen |= pro & (gen >> 4);  pro &= pro >> 4;
+            gen |= pro & (gen >> 8);  pro &= pro >> 8;
+            gen |= pro & (gen >> 16); pro &= pro >> 16;
+            gen |= pro & (gen >> 32);
+            v[w] = gen;
+            carry = (gen & 1) << 63;
+        }
+    }
+};
+
+#endif // BITBOARD_H
@@ -0,0 +1,319 @@
+#ifndef DISTANCEORACLE_H
+#define DISTANCEORACLE_H
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include "Graph.h"
+
+/*
+ * Oráculo de distancias sobre el Map (solo los obstáculos bloquean, igual que bfsPath).
+ *
+ * - Mapas pequeños: tabla exacta de todos los pares, calculada con un BFS por celda libre.
+ *   distance() es una lectura de la tabla.
+ * - Mapas grandes: ALT (A*, landmarks y desigualdad triangular). Se guardan las distancias
+ *   desde unos pocos landmarks elegidos lejos entre sí y lowerBound() da una cota inferior
+ *   admisible que sirve como heurística de A*.
+ *
+ * Las tablas se pueden guardar en disco y volver a cargar; al cargar se verifica con una
+ * huella de los obstáculos que el archivo corresponde al mismo mapa.
+ */
+class DistanceOracle {
+public:
+    enum class Mode : std::uint8_t { None = 0, Exact = 1, Landmarks = 2 };
+
+    static constexpr int UNREACHABLE = 1 << 29;
+    static const int DEFAULT_EXACT_CELL_LIMIT = 2048; // 2048^2 distancias de 16 bits = 8 MB
+    static const int DEFAULT_LANDMARKS = 16;
+
+    void build(const Map& gameMap, int exactCellLimit = DEFAULT_EXACT_CELL_LIMIT, int numLandmarks = DEFAULT_LANDMARKS) {
+        rows = gameMap.getNumRows();
+        cols = gameMap.getNumCols();
+        int numCells = rows * cols;
+        loadBlocked(gameMap);
+        fingerprint = computeFingerprint();
+        builtVersion = gameMap.getObstacleVersion();
+        sources.clear();
+        table.clear();
+
+        if (numCells <= exactCellLimit) {
+            mode = Mode::Exact;
+            table.assign(static_cast<std::size_t>(numCells) * numCells, NO_DISTANCE);
+            for (int c = 0; c < numCells; ++c) {
+                sources.push_back(c);
+                if (!blocked[c]) {
+                    bfs(c, table.data() + static_cast<std::size_t>(c) * numCells);
+                }
+            }
+        } else {
+            mode = Mode::Landmarks;
+            chooseLandmarks(std::max(numLandmarks, 1));
+        }
+    }
+
+    // ¿Las tablas corresponden todavía a los obstáculos del mapa?
+    bool isValidFor(const Map& gameMap) const {
+        return mode != Mode::None && gameMap.getNumRows() == rows && gameMap.getNumCols() == cols
+               && gameMap.getObstacleVersion() == builtVersion;
+    }
+
+    Mode getMode() const { return mode; }
+    int getNumLandmarks() const { return mode == Mode::Landmarks ? static_cast<int>(sources.size()) : 0; }
+
+    /*
+     * Distancia exacta en pasos, -1 si no hay camino. Solo disponible en modo exacto;
+     * con landmarks devuelve -1 y hay que usar lowerBound().
+     */
+    int distance(int row1, int col1, int row2, int col2) const {
+        if (mode != Mode::Exact || !isValid(row1, col1) || !isValid(row2, col2)) return -1;
+        std::uint16_t d = table[static_cast<std::size_t>(cell(row1, col1)) * rows * cols + cell(row2, col2)];
+        return d == NO_DISTANCE ? -1 : d;
+    }
+
+    /*
+     * Cota inferior de la distancia (nunca la sobreestima). En modo exacto es la distancia misma.
+     * Devuelve UNREACHABLE si se sabe que no hay camino entre las dos celdas.
+     */
+    int lowerBound(int row1, int col1, int row2, int col2) const {
+        int manhattan = std::abs(row1 - row2) + std::abs(col1 - col2);
+        if (!isValid(row1, col1) || !isValid(row2, col2)) return manhattan;
+        return lowerBoundCells(cell(row1, col1), cell(row2, col2), manhattan);
+    }
+
+    // Igual que lowerBound pero con índices de celda (fila * columnas + columna), para usar en búsquedas
+    int lowerBoundCells(int a, int b) const {
+        int manhattan = std::abs(a / cols - b / cols) + std::abs(a % cols - b % cols);
+        return lowerBoundCells(a, b, manhattan);
+    }
+
+    // Guardar las tablas en un archivo binario; devuelve false si no se pudo escribir
+    bool save(const std::string& path) const {
+        if (mode == Mode::None) return false;
+        std::ofstream out(path, std::ios::binary);
+        if (!out) return false;
+
+        std::uint32_t count = static_cast<std::uint32_t>(sources.size());
+        std::uint64_t tableSize = table.size();
+        out.write(FILE_MAGIC, 4);
+        writeValue(out, FILE_VERSION);
+        writeValue(out, rows);
+        writeValue(out, cols);
+        writeValue(out, static_cast<std::uint8_t>(mode));
+        writeValue(out, fingerprint);
+        writeValue(out, count);
+        writeValue(out, tableSize);
+        out.write(reinterpret_cast<const char*>(sources.data()), static_cast<std::streamsize>(count * sizeof(int)));
+        out.write(reinterpret_cast<const char*>(table.data()), static_cast<std::streamsize>(tableSize * sizeof(std::uint16_t)));
+        return static_cast<bool>(out);
+    }
+
+    /*
+     * Cargar tablas guardadas con save(). Devuelve false (y deja el oráculo como estaba) si el
+     * archivo no existe, está dañado o se calculó para otro mapa.
+     */
+    bool load(const std::string& path, const Map& gameMap) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) return false;
+
+        char magic[4];
+        std::uint32_t fileVersion = 0;
+        int fileRows = 0, fileCols = 0;
+        std::uint8_t fileMode = 0;
+        std::uint64_t fileFingerprint = 0;
+        std::uint32_t count = 0;
+        std::uint64_t tableSize = 0;
+        in.read(magic, 4);
+        readValue(in, fileVersion);
+        readValue(in, fileRows);
+        readValue(in, fileCols);
+        readValue(in, fileMode);
+        readValue(in, fileFingerprint);
+        readValue(in, count);
+        readValue(in, tableSize);
+        if (!in || !std::equal(magic, magic + 4, FILE_MAGIC) || fileVersion != FILE_VERSION) return false;
+        if (fileRows != gameMap.getNumRows() || fileCols != gameMap.getNumCols()) return false;
+
+        std::uint64_t numCells = static_cast<std::uint64_t>(fileRows) * fileCols;
+        bool sizesMatch = (fileMode == static_cast<std::uint8_t>(Mode::Exact) && count == numCells && tableSize == numCells * numCells)
+                          || (fileMode == static_cast<std::uint8_t>(Mode::Landmarks) && count > 0 && tableSize == count * numCells);
+        if (!sizesMatch) return false;
+
+        DistanceOracle loaded;
+        loaded.rows = fileRows;
+        loaded.cols = fileCols;
+        loaded.loadBlocked(gameMap);
+        if (loaded.computeFingerprint() != fileFingerprint) return false;
+
+        loaded.sources.resize(count);
+        loaded.table.resize(tableSize);
+        in.read(reinterpret_cast<char*>(loaded.sources.data()), static_cast<std::streamsize>(count * sizeof(int)));
+        in.read(reinterpret_cast<char*>(loaded.table.data()), static_cast<std::streamsize>(tableSize * sizeof(std::uint16_t)));
+        if (!in) return false;
+
+        loaded.mode = static_cast<Mode>(fileMode);
+        loaded.fingerprint = fileFingerprint;
+        loaded.builtVersion = gameMap.getObstacleVersion();
+        *this = std::move(loaded);
+        return true;
+    }
+
+    // Cargar desde disco si el archivo sirve para este mapa; si no, calcular y guardar
+    bool loadOrBuild(const std::string& path, const Map& gameMap,
+                     int exactCellLimit = DEFAULT_EXACT_CELL_LIMIT, int numLandmarks = DEFAULT_LANDMARKS) {
+        if (load(path, gameMap)) return true;
+        build(gameMap, exactCellLimit, numLandmarks);
+        return save(path);
+    }
+
+private:
+    // Las distancias se guardan en 16 bits; las muy largas se recortan, lo que mantiene la cota admisible
+    static constexpr std::uint16_t NO_DISTANCE = 0xFFFF;
+    static constexpr std::uint16_t MAX_STORED = 0xFFFE;
+    static constexpr char FILE_MAGIC[4] = {'T', 'A', 'D', 'O'};
+    static constexpr std::uint32_t FILE_VERSION = 1;
+
+    Mode mode = Mode::None;
+    int rows = 0;
+    int cols = 0;
+    std::uint64_t fingerprint = 0;
+    std::uint64_t builtVersion = 0;
+    std::vector<std::uint8_t> blocked;
+    std::vector<int> sources;          // Modo exacto: todas las celdas; con landmarks: las celdas landmark
+    std::vector<std::uint16_t> table;  // sources.size() filas de rows * cols distancias
+
+    int cell(int row, int col) const { return row * cols + col; }
+    bool isValid(int row, int col) const { return row >= 0 && row < rows && col >= 0 && col < cols; }
+
+    void loadBlocked(const Map& gameMap) {
+        blocked.assign(static_cast<std::size_t>(rows) * cols, 0);
+        for (int i = 0; i < rows; ++i) {
+            for (int j = 0; j < cols; ++j) {
+                blocked[cell(i, j)] = gameMap.isObstacle(i, j) ? 1 : 0;
+            }
+        }
+    }
+
+    // FNV-1a sobre las dimensiones y los obstáculos
+    std::uint64_t computeFingerprint() const {
+        std::uint64_t hash = 1469598103934665603ULL;
+        auto mix = [&hash](std::uint64_t value) {
+            hash ^= value;
+            hash *= 1099511628211ULL;
+        };
+        mix(static_cast<std::uint64_t>(rows));
+        mix(static_cast<std::uint64_t>(cols));
+        for (std::uint8_t b : blocked) mix(b);
+        return hash;
+    }
+
+    int lowerBoundCells(int a, int b, int manhattan) const {
+        // Una búsqueda puede empezar sobre un obstáculo (como en dijkstraPath): ahí no hay información
+        if (mode == Mode::None || blocked[a] || blocked[b]) return manhattan;
+        if (mode == Mode::Exact) {
+            std::uint16_t d = table[static_cast<std::size_t>(a) * rows * cols + b];
+            return d == NO_DISTANCE ? UNREACHABLE : d;
+        }
+        int best = manhattan;
+        const std::size_t numCells = static_cast<std::size_t>(rows) * cols;
+        for (std::size_t l = 0; l < sources.size(); ++l) {
+            const std::uint16_t* fromLandmark = table.data() + l * numCells;
+            std::uint16_t da = fromLandmark[a];
+            std::uint16_t db = fromLandmark[b];
+            if ((da == NO_DISTANCE) != (db == NO_DISTANCE)) {
+                return UNREACHABLE; // Una está en la componente del landmark y la otra no
+            }
+            if (da != NO_DISTANCE) {
+                best = std::max(best, std::abs(static_cast<int>(da) - static_cast<int>(db)));
+            }
+        }
+        return best;
+    }
+
+    // BFS desde una celda escribiendo las distancias en `out` (rows * cols valores)
+    void bfs(int source, std::uint16_t* out) const {
+        const int numCells = rows * cols;
+        std::vector<int> queue;
+        queue.reserve(numCells);
+        out[source] = 0;
+        queue.push_back(source);
+        for (std::size_t head = 0; head < queue.size(); ++head) {
+            int current = queue[head];
+            std::uint16_t next = out[current] >= MAX_STORED ? MAX_STORED : static_cast<std::uint16_t>(out[current] + 1);
+            int row = current / cols;
+            int col = current % cols;
+            auto visit = [&](int neighbor) {
+                if (!blocked[neighbor] && out[neighbor] == NO_DISTANCE) {
+                    out[neighbor] = next;
+                    queue.push_back(neighbor);
+                }
+            };
+            if (col + 1 < cols) visit(current + 1);
+            if (row + 1 < rows) visit(current + cols);
+            if (col > 0) visit(current - 1);
+            if (row > 0) visit(current - cols);
+        }
+    }
+
+    /*
+     * Elegir landmarks lejos entre sí: el primero es la celda más lejana a una celda libre
+     * cualquiera y cada siguiente la que maximiza la distancia al landmark más cercano.
+     * Las celdas de otras componentes se eligen con prioridad para que también tengan cota.
+     */
+    void chooseLandmarks(int numLandmarks) {
+        const int numCells = rows * cols;
+        int seed = -1;
+        for (int c = 0; c < numCells && seed < 0; ++c) {
+            if (!blocked[c]) seed = c;
+        }
+        if (seed < 0) {
+            mode = Mode::None;
+            return;
+        }
+
+        std::vector<std::uint16_t> scratch(numCells, NO_DISTANCE);
+        bfs(seed, scratch.data());
+        std::vector<int> nearest(numCells, UNREACHABLE); // Distancia al landmark más cercano
+        int candidate = farthest(scratch, seed);
+
+        for (int l = 0; l < numLandmarks && candidate >= 0; ++l) {
+            sources.push_back(candidate);
+            table.resize(table.size() + numCells, NO_DISTANCE);
+            std::uint16_t* row = table.data() + static_cast<std::size_t>(l) * numCells;
+            bfs(candidate, row);
+
+            candidate = -1;
+            int bestScore = 0;
+            for (int c = 0; c < numCells; ++c) {
+                if (blocked[c]) continue;
+                if (row[c] != NO_DISTANCE) nearest[c] = std::min(nearest[c], static_cast<int>(row[c]));
+                if (nearest[c] > bestScore) {
+                    bestScore = nearest[c];
+                    candidate = c;
+                }
+            }
+        }
+    }
+
+    int farthest(const std::vector<std::uint16_t>& distances, int fallback) const {
+        int best = fallback;
+        for (int c = 0; c < static_cast<int>(distances.size()); ++c) {
+            if (distances[c] != NO_DISTANCE && distances[c] > distances[best]) best = c;
+        }
+        return best;
+    }
+
+    template <typename T>
+    static void writeValue(std::ofstream& out, const T& value) {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    static void readValue(std::ifstream& in, T& value) {
+        in.read(reinterpret_cast<char*>(&value), sizeof(T));
+    }
+};
+
+#endif // DISTANCEORACLE_H
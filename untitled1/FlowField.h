@@ -0,0 +1,194 @@
+#ifndef FLOWFIELD_H
+#define FLOWFIELD_H
+
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+#include <QPoint>
+#include "Graph.h"
+
+/*
+ * Campo de flujo: un BFS inverso desde uno o varios objetivos deja en cada celda la distancia
+ * al objetivo más cercano y la dirección del siguiente paso. Después cualquier cantidad de
+ * tanques puede seguir el campo con una lectura por paso, sin buscar de nuevo.
+ *
+ * Se transita igual que en bfsPath: solo los obstáculos bloquean, así que el campo solo
+ * depende de los obstáculos del mapa (getObstacleVersion).
+ */
+class FlowField {
+public:
+    static constexpr int UNREACHED = -1;
+    static constexpr std::uint8_t NO_DIRECTION = 4; // Objetivo o celda sin camino
+
+    // Direcciones: 0 = derecha, 1 = abajo, 2 = izquierda, 3 = arriba
+    static constexpr int DIR_ROW[4] = {0, 1, 0, -1};
+    static constexpr int DIR_COL[4] = {1, 0, -1, 0};
+
+    void build(const Map& gameMap, int targetRow, int targetCol) {
+        build(gameMap, std::vector<QPoint>{{targetRow, targetCol}});
+    }
+
+    // Varios objetivos a la vez: cada celda apunta hacia el más cercano
+    void build(const Map& gameMap, const std::vector<QPoint>& targets) {
+        rows = gameMap.getNumRows();
+        cols = gameMap.getNumCols();
+        builtVersion = gameMap.getObstacleVersion();
+        std::size_t numCells = static_cast<std::size_t>(rows) * cols;
+        distances.assign(numCells, UNREACHED);
+        directions.assign(numCells, NO_DIRECTION);
+        queue.clear();
+        queue.reserve(numCells);
+
+        for (const QPoint& target : targets) {
+            if (!gameMap.isValidIndex(target.x(), target.y()) || gameMap.isObstacle(target.x(), target.y())) continue;
+            int c = cell(target.x(), target.y());
+            if (distances[c] == UNREACHED) {
+                distances[c] = 0;
+                queue.push_back(c);
+            }
+        }
+
+        for (std::size_t head = 0; head < queue.size(); ++head) {
+            int current = queue[head];
+            int row = current / cols;
+            int col = current % cols;
+            for (int dir = 0; dir < 4; ++dir) {
+                int newRow = row + DIR_ROW[dir];
+                int newCol = col + DIR_COL[dir];
+                if (!gameMap.isValidIndex(newRow, newCol) || gameMap.isObstacle(newRow, newCol)) continue;
+                int next = cell(newRow, newCol);
+                if (distances[next] == UNREACHED) {
+                    distances[next] = distances[current] + 1;
+                    directions[next] = static_cast<std::uint8_t>((dir + 2) % 4); // Volver por donde llegó el BFS
+                    queue.push_back(next);
+                }
+            }
+        }
+    }
+
+    bool isBuiltFor(const Map& gameMap) const {
+        return gameMap.getNumRows() == rows && gameMap.getNumCols() == cols
+               && gameMap.getObstacleVersion() == builtVersion;
+    }
+
+    // Pasos hasta el objetivo más cercano, UNREACHED si no hay camino
+    int distance(int row, int col) const {
+        if (!isValid(row, col)) return UNREACHED;
+        return distances[cell(row, col)];
+    }
+
+    /*
+     * Siguiente celda desde (row, col). Devuelve false si ya está en un objetivo o no hay camino.
+     * Desde una celda que no está en el campo (por ejemplo un obstáculo, como permite bfsPath)
+     * se toma el vecino con menor distancia.
+     */
+    bool nextStep(int row, int col, QPoint& next) const {
+        if (!isValid(row, col)) return false;
+        int c = cell(row, col);
+        if (distances[c] != UNREACHED) {
+            std::uint8_t dir = directions[c];
+            if (dir == NO_DIRECTION) return false;
+            next = QPoint(row + DIR_ROW[dir], col + DIR_COL[dir]);
+            return true;
+        }
+
+        int best = UNREACHED;
+        for (int dir = 0; dir < 4; ++dir) {
+            int d = distance(row + DIR_ROW[dir], col + DIR_COL[dir]);
+            if (d != UNREACHED && (best == UNREACHED || d < best)) {
+                best = d;
+                next = QPoint(row + DIR_ROW[dir], col + DIR_COL[dir]);
+            }
+        }
+        return best != UNREACHED;
+    }
+
+    // Camino completo desde (row, col) como el de bfsPath: incluye el inicio, vacío si no hay camino
+    std::vector<QPoint> pathFrom(int row, int col) const {
+        if (!isValid(row, col)) return {};
+        std::vector<QPoint> path;
+        QPoint at(row, col);
+        path.push_back(at);
+        QPoint next;
+        while (nextStep(at.x(), at.y(), next)) {
+            at = next;
+            path.push_back(at);
+        }
+        return distance(at.x(), at.y()) == 0 ? path : std::vector<QPoint>();
+    }
+
+private:
+    int rows = 0;
+    int cols = 0;
+    std::uint64_t builtVersion = 0;
+    std::vector<int> distances;
+    std::vector<std::uint8_t> directions;
+    std::vector<int> queue;
+
+    int cell(int row, int col) const { return row * cols + col; }
+    bool isValid(int row, int col) const { return row >= 0 && row < rows && col >= 0 && col < cols; }
+};
+
+/*
+ * Campos de flujo guardados por objetivo para un mapa. Un campo se recalcula solo cuando
+ * cambian los obstáculos; si hay demasiados objetivos distintos se descarta el menos usado.
+ */
+class FlowFieldCache {
+public:
+    static const int DEFAULT_CAPACITY = 16;
+
+    explicit FlowFieldCache(int capacity = DEFAULT_CAPACITY) : capacity(capacity > 0 ? capacity : 1) {}
+
+    const FlowField& get(const Map& gameMap, int targetRow, int targetCol) {
+        int key = targetRow * gameMap.getNumCols() + targetCol;
+        auto it = fields.find(key);
+        if (it == fields.end()) {
+            if (static_cast<int>(fields.size()) >= capacity) evictLeastRecent();
+            it = fields.emplace(key, Entry{}).first;
+        }
+
+        Entry& entry = it->second;
+        entry.lastUse = ++useCounter;
+        if (!entry.field.isBuiltFor(gameMap) || entry.targetRow != targetRow || entry.targetCol != targetCol) {
+            entry.field.build(gameMap, targetRow, targetCol);
+            entry.targetRow = targetRow;
+            entry.targetCol = targetCol;
+            ++builds;
+        }
+        return entry.field;
+    }
+
+    std::vector<QPoint> path(const Map& gameMap, int startRow, int startCol, int targetRow, int targetCol) {
+        if (!gameMap.isValidIndex(startRow, startCol) || !gameMap.isValidIndex(targetRow, targetCol)) return {};
+        if (startRow == targetRow && startCol == targetCol) return {{startRow, startCol}}; // Igual que bfsPath
+        return get(gameMap, targetRow, targetCol).pathFrom(startRow, startCol);
+    }
+
+    void clear() { fields.clear(); }
+
+    // Cuántas veces se tuvo que construir un campo (para medir el acierto de la caché)
+    long long getBuilds() const { return builds; }
+
+private:
+    struct Entry {
+        FlowField field;
+        int targetRow = -1;
+        int targetCol = -1;
+        long long lastUse = 0;
+    };
+
+    int capacity;
+    long long useCounter = 0;
+    long long builds = 0;
+    std::unordered_map<int, Entry> fields;
+
+    void evictLeastRecent() {
+        auto oldest = fields.begin();
+        for (auto it = fields.begin(); it != fields.end(); ++it) {
+            if (it->second.lastUse < oldest->second.lastUse) oldest = it;
+        }
+        if (oldest != fields.end()) fields.erase(oldest);
+    }
+};
+
+#endif // FLOWFIELD_H
@@ -4,23 +4,31 @@
 #include <QGraphicsView>
 #include <QGraphicsScene>
 #include <QMouseEvent>
+#include <QWheelEvent>
 #include <QPen>
 #include <QDebug>
 #include <QBrush>
 #include <QWidget>
+#include <QHash>
 #include <iostream>
-#include <random>
+#include <algorithm>
+#include <cmath>
 #include "Graph.h"
 #include "Tank.h"
 #include "Player.h"
-#include "Pathfinding.h" // Incluye los algoritmos de movimiento
+#include "TileLayerItem.h"
+#include "TankAnimator.h"
+#include "AsyncPathService.h"
+#include "GameSimulation.h" // Reglas del juego; esta clase solo las dibuja
 
-class GameLaunch : public QGraphicsView {
+class GameLaunch : public QGraphicsView, public GameObserver {
     Q_OBJECT
 
 private:
-    Map gameMap;
+    GameSimulation simulation;
+    const Map& gameMap; // Mapa de la simulación, solo para dibujar
     QGraphicsScene scene;
+    TileLayerItem* tileLayer = nullptr; // Toda la cuadrícula en un solo item
     int numRows;
     int numCols;
     int tileSize;
@@ -29,19 +37,36 @@ private:
     Player player2;
     Tank* selectedTank = nullptr; // Tanque seleccionado
     QList<QGraphicsLineItem*> currentPathLines; // Lista para almacenar las líneas de la ruta actual
+    QList<QGraphicsLineItem*> shotPathLines; // Recorrido del último disparo: sobrevive al cambio de turno
+    QList<Tank*> tankViews; // Índice = id del tanque en la simulación; nullptr si ya fue destruido
+    QHash<const Tank*, int> tankIds; // Figura -> id del tanque en la simulación
+    // Cambios del turno que todavía no se dibujaron; se aplican juntos al pasar el turno
+    QHash<int, std::vector<QPoint>> movedTanks; // Id -> celdas recorridas en el turno
+    TankAnimator animator;
+    AsyncPathService pathService{this}; // Los caminos se buscan en otros hilos
+    GameSimulation::MovePlan pendingMove; // Movimiento esperando su camino
+    bool healthChanged = false;
+    bool detailed = true; // Con poco zoom se esconden tanques y rutas y la cuadrícula dibuja bloques
+
+    static constexpr qreal MIN_ZOOM = 0.002;
+    static constexpr qreal MAX_ZOOM = 4.0;
+    static constexpr qreal ZOOM_STEP = 1.15; // Por cada paso de la rueda
+    static const int MAX_INITIAL_WIDTH = 1280;
+    static const int MAX_INITIAL_HEIGHT = 900;
 
     QList<QGraphicsTextItem*> player1HealthTexts;
     QList<QGraphicsTextItem*> player2HealthTexts;
 
     public:
         GameLaunch(QWidget *parent = nullptr)
-            : QGraphicsView(parent), numRows(gameMap.getNumRows()), numCols(gameMap.getNumCols()), tileSize(50) {
+            : QGraphicsView(parent), gameMap(simulation.getMap()), numRows(gameMap.getNumRows()), numCols(gameMap.getNumCols()), tileSize(50) {
             // Configurar la escena
             scene.setSceneRect(0, 0, tileSize * numCols, tileSize * numRows);
             this->setScene(&scene);
             scene.setBackgroundBrush(QBrush(QColor(139, 115, 85))); // Example: Sky blue color
 
-            gameMap.generateObstacles();
+            simulation.setMaxTurns(0); // En la ventana se juega sin límite de turnos
+            simulation.setup();
             drawGrid();
             placeInitialTanks();
             gameMap.printMatrix();
@@ -50,33 +75,116 @@ private:
 
 
             setWindowTitle("Tank Attack!");
-            setFixedSize(tileSize * numCols + 20, tileSize * numRows + 20);
+            // La ventana se puede agrandar, desplazar y acercar con la rueda: el mapa ya no tiene que caber entero.
+            // La escena solo pinta los items que tocan la parte visible (índice BSP) y la cuadrícula
+            // solo las celdas expuestas, así que el costo de cada cuadro depende de lo que se ve
+            scene.setItemIndexMethod(QGraphicsScene::BspTreeIndex);
+            setTransformationAnchor(QGraphicsView::AnchorUnderMouse);
+            setResizeAnchor(QGraphicsView::AnchorViewCenter);
+            setHorizontalScrollBarPolicy(Qt::ScrollBarAsNeeded);
+            setVerticalScrollBarPolicy(Qt::ScrollBarAsNeeded);
+            // Solo se repinta la unión de lo que cambió; el fondo liso se guarda en caché
+            setViewportUpdateMode(QGraphicsView::MinimalViewportUpdate);
+            setCacheMode(QGraphicsView::CacheBackground);
+            setOptimizationFlags(QGraphicsView::DontSavePainterState | QGraphicsView::DontAdjustForAntialiasing);
+            resize(std::min(tileSize * numCols + 20, MAX_INITIAL_WIDTH), std::min(tileSize * numRows + 20, MAX_INITIAL_HEIGHT));
 
             player1.setTurn(true);
             player2.setTurn(false);
 
+            simulation.addObserver(this);
         }
 
-    protected:
+        ~GameLaunch() override {
+            simulation.removeObserver(this);
+        }
 
-        void drawGrid() {
+        // Avisos de la simulación
+        void onTankMoved(const TankState& state, const std::vector<QPoint>& path) override {
+            if (!tankViews.value(state.id)) return;
+            // La figura se anima una sola vez al terminar el turno, por todas las celdas que recorrió
+            std::vector<QPoint>& route = movedTanks[state.id];
+            route.insert(route.end(), path.begin(), path.end());
+            drawPath(convertToQVector(path)); // Dibujar la ruta calculada
+        }
 
-            for (int row = 0; row < numRows; ++row) {
-                for (int col = 0; col < numCols; ++col) {
-                    QGraphicsRectItem *rect = scene.addRect(col * tileSize, row * tileSize, tileSize, tileSize);
+        void onTankDamaged(const TankState& state, int) override {
+            if (!tankViews.value(state.id)) return;
+            healthChanged = true; // El Tank lee la vida del registro de la simulación
+            if (state.isDestroyed()) removeTankView(state.id);
+        }
 
-                    //esto es la solución que se encontró para poder poner el texto y que no afectara al resto de cosas
-                    if (row >= numRows - 2) {
-                        rect->setBrush(Qt::black);
-                        rect->setPen(Qt::NoPen);
-                    } else if (gameMap.isObstacle(row, col)) {
-                        rect->setBrush(QColor(139, 115, 85));
-                    } else {
-                        rect->setBrush(QColor(210, 180, 140));
-                        rect->setPen(QPen(Qt::black));
-                    }
+        void onShotFired(const TankState&, const std::vector<QPoint>& path, const ShotResult&) override {
+            // El disparo pasa el turno en la misma llamada: si se borrara con la ruta no llegaría a verse
+            clearShotPath();
+            addPathLines(convertToQVector(path), Qt::red, shotPathLines);
+        }
+
+        void onTurnChanged(int currentPlayer) override {
+            // Cambiar los turnos entre los jugadores
+            player1.setTurn(currentPlayer == 0);
+            player2.setTurn(currentPlayer == 1);
+            clearCurrentPath(); // Borrar la ruta actual al cambiar de turno
+            flushTurnChanges();
+        }
+
+        void onGameOver(int winner) override {
+            qDebug() << "Fin del juego. Ganador:" << (winner < 0 ? QString("empate") : QString("Player %1").arg(winner + 1));
+        }
+
+    protected:
+
+        /*
+         * Un tanque destruido deja de verse y de recibir clics: se esconde su figura, se corta su
+         * animación y, si su movimiento seguía buscando camino, se cancela. El Tank sigue en su
+         * jugador para el texto de vida.
+         */
+        void removeTankView(int tankId) {
+            Tank *tank = tankViews.value(tankId);
+            if (!tank) return;
+            animator.cancel(tank->getGraphicsItem());
+            tank->getGraphicsItem()->setVisible(false);
+            movedTanks.remove(tankId);
+            if (pendingMove.tankId == tankId) pathService.cancelAll();
+            if (selectedTank == tank) selectedTank = nullptr;
+            tankIds.remove(tank);
+            tankViews[tankId] = nullptr;
+        }
+
+        /*
+         * Aplicar a la escena todo lo que cambió en el turno: cada tanque empieza una sola animación
+         * por su ruta hasta la posición final aunque haya recibido varios avisos, los textos de vida
+         * se reescriben una vez y la cuadrícula repinta solo las celdas cambiadas. La escena junta
+         * esas áreas y la vista las repinta en un solo cuadro.
+         */
+        void flushTurnChanges() {
+            for (auto it = movedTanks.cbegin(); it != movedTanks.cend(); ++it) {
+                TankState state = simulation.getTank(it.key());
+                Tank *tank = tankViews.value(it.key());
+                if (!tank) continue;
+                tank->setCell(state.row, state.col);
+                std::vector<QPointF> waypoints;
+                for (const QPoint& cell : it.value()) {
+                    waypoints.push_back(Tank::itemPosition(cell.x(), cell.y()));
+                }
+                if (waypoints.empty() || waypoints.back() != Tank::itemPosition(state.row, state.col)) {
+                    waypoints.push_back(Tank::itemPosition(state.row, state.col));
                 }
+                animator.animate(tank->getGraphicsItem(), std::move(waypoints));
             }
+            movedTanks.clear();
+            if (healthChanged) {
+                updateHealthTexts();
+                healthChanged = false;
+            }
+            if (tileLayer) tileLayer->syncWithMap(); // Solo se repintan las celdas que cambiaron
+        }
+
+        // Las dos últimas filas quedan negras para poder poner el texto sin afectar al resto de cosas
+        void drawGrid() {
+            tileLayer = new TileLayerItem(gameMap, tileSize, 2);
+            tileLayer->setZValue(-1); // Debajo de los tanques y las rutas
+            scene.addItem(tileLayer);
         }
 
 
@@ -146,154 +254,40 @@ private:
             }
         }
 
-        void switchTurn() {
-            // Cambiar los turnos entre los jugadores
-            player1.setTurn(!player1.getTurn());
-            player2.setTurn(!player2.getTurn());
-            clearCurrentPath(); // Borrar la ruta actual al cambiar de turno
-        }
-
-        void placeTank(int row, int col, const QColor &color) {
-            int maxHealth = 100;
-            Tank *tank = new Tank(row, col, color, &scene, maxHealth);
+        void placeTank(const TankState& state) {
+            const TankRegistry& registry = simulation.getRegistry();
+            Tank *tank = new Tank(registry.ref(registry.handle(static_cast<std::uint32_t>(state.id))), tankColor(state.color), &scene);
+            tank->getGraphicsItem()->setVisible(detailed);
+            tankIds.insert(tank, tankViews.size());
+            tankViews.append(tank);
 
-            if (color == Qt::red || color == Qt::blue) {
+            if (state.owner == 0) {
                 player1.addTank(tank);
             } else {
                 player2.addTank(tank);
             }
         }
 
+        // La simulación ya colocó los tanques; aquí solo se crean sus figuras
         void placeInitialTanks() {
-        QRandomGenerator *randGen = QRandomGenerator::global();
-
-        // Colocar tanques rojos y azules en las primeras dos columnas de la izquierda
-        for (int i = 0; i < 2; ++i) {
-            int row, col;
-
-            // Buscar posiciones aleatorias para los tanques rojos
-            do {
-                row = randGen->bounded(numRows);
-                col = randGen->bounded(0, 2); // Se limitan las columnas
-            } while (gameMap.isObstacle(row, col) || gameMap.isOccupied(row, col));
-
-            placeTank(row, col, Qt::red); // Se coloca el tanque y se agrega al jugador 1
-            gameMap.addEdge(row, col); // Marca la celda como ocupada
-        }
-
-        for (int i = 0; i < 2; ++i) {
-            int row, col;
-
-            // Buscar posiciones aleatorias para los tanques azules
-            do {
-                row = randGen->bounded(numRows);
-                col = randGen->bounded(0, 2);
-            } while (gameMap.isObstacle(row, col) || gameMap.isOccupied(row, col));
-
-            placeTank(row, col, Qt::blue); // Se coloca el tanque y se agrega al jugador 2
-            gameMap.addEdge(row, col);
-        }
-
-        // Colocar tanques amarillos y celestes en las primeras dos columnas de la derecha
-        for (int i = 0; i < 2; ++i) {
-            int row, col;
-
-            // Buscar posiciones aleatorias para los tanques amarillos
-            do {
-                row = randGen->bounded(numRows);
-                col = randGen->bounded(numCols - 2, numCols);
-            } while (gameMap.isObstacle(row, col) || gameMap.isOccupied(row, col));
-
-            placeTank(row, col, Qt::yellow); // Se coloca el tanque y se agrega al jugador 1
-            gameMap.addEdge(row, col);
-        }
-
-        for (int i = 0; i < 2; ++i) {
-            int row, col;
-
-            // Buscar posiciones aleatorias para los tanques celestes
-            do {
-                row = randGen->bounded(numRows);
-                col = randGen->bounded(numCols - 2, numCols);
-            } while (gameMap.isObstacle(row, col) || gameMap.isOccupied(row, col));
-
-            placeTank(row, col, Qt::cyan); // Se coloca el tanque y se agrega al jugador 2
-            gameMap.addEdge(row, col);
-        }
-    }
-
-        void moveTank(Tank *tank, int newRow, int newCol) {
-            int oldRow = tank->getRow();
-            int oldCol = tank->getCol();
-            gameMap.removeEdge(oldRow, oldCol);
-            gameMap.addEdge(newRow, newCol);
-            tank->updatePosition(newRow, newCol);
-            updateTankGraphics(tank);
-        }
-
-        void updateTankGraphics(Tank *tank) {
-            tank->getGraphicsItem()->setRect(tank->getCol() * tileSize + 10, tank->getRow() * tileSize + 10, tileSize - 20, tileSize - 20);
+            for (const TankState& state : simulation.getTanks()) {
+                placeTank(state);
+            }
         }
 
-        Tank* findTankAt(int row, int col) {
-            for (Tank* tank : player1.getTanks()) {
-                if (tank->getRow() == row && tank->getCol() == col) {
-                    return tank;
-                }
+        static QColor tankColor(TankColor color) {
+            switch (color) {
+                case TankColor::Red: return Qt::red;
+                case TankColor::Blue: return Qt::blue;
+                case TankColor::Yellow: return Qt::yellow;
+                case TankColor::Cyan:
+                default: return Qt::cyan;
             }
-            for (Tank* tank : player2.getTanks()) {
-                if (tank->getRow() == row && tank->getCol() == col) {
-                    return tank;
-                }
-            }
-            return nullptr;
         }
 
-        void executeMovementAlgorithm(Tank *tank, int targetRow, int targetCol) {
-            if (!tank) return;
-
-            QColor color = tank->getColor();
-            std::random_device rd;
-            std::mt19937 gen(rd());
-            std::uniform_int_distribution<> dist(1, 100);
-
-            int randomPercentage = dist(gen);
-
-            if (color == Qt::cyan || color == Qt::blue) {
-                // 50% BFS y 50% movimiento aleatorio
-                if (randomPercentage <= 50) {
-                    qDebug() << "Usando BFS para el tanque.";
-                    auto path = Pathfinding::bfsPath(gameMap, tank->getRow(), tank->getCol(), targetRow, targetCol);
-                    drawPath(convertToQVector(path)); // Dibujar la ruta calculada
-                    for (const auto& point : path) {
-                        moveTank(tank, point.x(), point.y());
-                    }
-                } else {
-                    qDebug() << "Usando movimiento aleatorio para el tanque.";
-                    auto path = Pathfinding::randomMove(gameMap, tank->getRow(), tank->getCol());
-                    drawPath(convertToQVector(path)); // Dibujar la ruta calculada
-                    for (const auto& point : path) {
-                        moveTank(tank, point.x(), point.y());
-                    }
-                }
-            } else if (color == Qt::red || color == Qt::yellow) {
-                // 80% Dijkstra y 20% movimiento aleatorio
-                if (randomPercentage <= 80) {
-                    qDebug() << "Usando Dijkstra para el tanque.";
-                    auto path = Pathfinding::dijkstraPath(gameMap, tank->getRow(), tank->getCol(), targetRow, targetCol);
-                    drawPath(convertToQVector(path)); // Dibujar la ruta calculada
-                    for (const auto& point : path) {
-                        moveTank(tank, point.x(), point.y());
-                    }
-                } else {
-                    qDebug() << "Usando movimiento aleatorio para el tanque.";
-                    auto path = Pathfinding::randomMove(gameMap, tank->getRow(), tank->getCol());
-                    drawPath(convertToQVector(path)); // Dibujar la ruta calculada
-                    for (const auto& point : path) {
-                        moveTank(tank, point.x(), point.y());
-                    }
-                }
-            }
+        // Búsqueda en el índice de ocupación de la simulación, sin recorrer los tanques
+        Tank* findTankAt(int row, int col) {
+            return tankViews.value(simulation.tankAt(row, col), nullptr);
         }
 
         QVector<QPoint> convertToQVector(const std::vector<QPoint> &vec) {
@@ -304,39 +298,115 @@ private:
             return qVec;
         }
 
-        void drawPath(const QVector<QPoint> &path) {
+        void drawPath(const QVector<QPoint> &path, const QColor& color = Qt::green) {
             clearCurrentPath(); // Borrar la ruta anterior
-            QPen pen(Qt::green);
+            addPathLines(path, color, currentPathLines);
+        }
+
+        // Las celdas son (fila, columna): la columna va en el eje X de la escena, como en Tank::itemPosition
+        void addPathLines(const QVector<QPoint> &path, const QColor& color, QList<QGraphicsLineItem*>& lines) {
+            QPen pen(color);
             pen.setWidth(2);
             for (int i = 0; i < path.size() - 1; ++i) {
-                QGraphicsLineItem *line = scene.addLine(path[i].x() * tileSize + tileSize / 2, path[i].y() * tileSize + tileSize / 2,
-                                                        path[i + 1].x() * tileSize + tileSize / 2, path[i + 1].y() * tileSize + tileSize / 2, pen);
-                currentPathLines.append(line);
+                QGraphicsLineItem *line = scene.addLine(path[i].y() * tileSize + tileSize / 2, path[i].x() * tileSize + tileSize / 2,
+                                                        path[i + 1].y() * tileSize + tileSize / 2, path[i + 1].x() * tileSize + tileSize / 2, pen);
+                line->setVisible(detailed);
+                lines.append(line);
             }
         }
 
         void clearCurrentPath() {
-            for (QGraphicsLineItem *line : currentPathLines) {
+            clearLines(currentPathLines);
+        }
+
+        void clearShotPath() {
+            clearLines(shotPathLines);
+        }
+
+        void clearLines(QList<QGraphicsLineItem*>& lines) {
+            for (QGraphicsLineItem *line : lines) {
                 scene.removeItem(line);
                 delete line;
             }
-            currentPathLines.clear();
+            lines.clear();
+        }
+
+        /*
+         * La simulación sortea el movimiento y, si hay que buscar camino, la búsqueda corre en el
+         * pool; al volver, la simulación mueve el tanque y pasa el turno y los avisos actualizan la
+         * escena. Otro clic antes de que termine cancela la búsqueda anterior.
+         */
+        void requestMove(int tankId, int targetRow, int targetCol) {
+            GameSimulation::MovePlan plan;
+            if (!simulation.beginMove(tankId, targetRow, targetCol, plan)) return;
+            if (!plan.needsSearch) {
+                pathService.cancelAll();
+                simulation.finishMove(plan); // Movimiento aleatorio, ya resuelto
+                return;
+            }
+            pendingMove = std::move(plan);
+            pathService.request(gameMap, pendingMove.algorithm, pendingMove.startRow, pendingMove.startCol, targetRow, targetCol,
+                                [this](std::uint64_t ticket, std::vector<QPoint> path) {
+                                    if (ticket != pathService.getLastTicket()) return;
+                                    pendingMove.path = std::move(path);
+                                    if (!simulation.finishMove(pendingMove)) qDebug() << "Camino descartado: la partida cambió mientras se buscaba";
+                                });
+        }
+
+        // Rueda: acercar o alejar alrededor del cursor
+        void wheelEvent(QWheelEvent *event) override {
+            int steps = event->angleDelta().y() / 120;
+            if (steps == 0) return;
+            qreal current = transform().m11();
+            qreal target = std::clamp(current * std::pow(ZOOM_STEP, steps), MIN_ZOOM, MAX_ZOOM);
+            scale(target / current, target / current);
+            updateLevelOfDetail();
+            event->accept();
+        }
+
+        // Con poco zoom los tanques y las rutas no se distinguen: se esconden y la cuadrícula los marca por bloque
+        void updateLevelOfDetail() {
+            bool nowDetailed = !tileLayer || tileLayer->isDetailed(transform().m11());
+            if (nowDetailed == detailed) return;
+            detailed = nowDetailed;
+            for (Tank *tank : tankViews) {
+                if (tank) tank->getGraphicsItem()->setVisible(detailed);
+            }
+            for (QGraphicsLineItem *line : currentPathLines) {
+                line->setVisible(detailed);
+            }
+            for (QGraphicsLineItem *line : shotPathLines) {
+                line->setVisible(detailed);
+            }
         }
 
         void mousePressEvent(QMouseEvent *event) override {
+            // Con desplazamiento y zoom la posición en la vista ya no es la de la escena
+            QPointF scenePos = mapToScene(event->position().toPoint());
+            int row = static_cast<int>(std::floor(scenePos.y() / tileSize));
+            int col = static_cast<int>(std::floor(scenePos.x() / tileSize));
             if (event->button() == Qt::LeftButton) {
                 if (selectedTank) {
-                    int targetRow = event->position().y() / tileSize; // Asignar la fila de destino
-                    int targetCol = event->position().x() / tileSize; // Asignar la columna de destino
-                    executeMovementAlgorithm(selectedTank, targetRow, targetCol);
-                    switchTurn();
-                    selectedTank = nullptr; // Deseleccionar el tanque después de moverlo
+                    clearShotPath(); // El disparo anterior se borra con la siguiente acción
+                    int targetRow = row; // Asignar la fila de destino
+                    int targetCol = col; // Asignar la columna de destino
+                    int tankId = tankIds.value(selectedTank, -1);
+                    Qt::KeyboardModifiers modifiers = event->modifiers();
+                    if (modifiers & Qt::ControlModifier) {
+                        // Ctrl: disparar (con Shift rebota, con Alt atraviesa obstáculos)
+                        ProjectileType type = (modifiers & Qt::ShiftModifier) ? ProjectileType::Bouncing
+                                              : (modifiers & Qt::AltModifier) ? ProjectileType::Piercing
+                                                                              : ProjectileType::Standard;
+                        pathService.cancelAll(); // Un movimiento que seguía buscando camino ya no vale
+                        simulation.fire(tankId, targetRow, targetCol, type);
+                    } else {
+                        requestMove(tankId, targetRow, targetCol);
+                    }
+                    selectedTank = nullptr; // Deseleccionar el tanque después de moverlo o disparar
                 }
             } else if (event->button() == Qt::RightButton) {
-                QGraphicsItem *item = itemAt(event->position().toPoint());
-                if (!item) return;
-
-                Tank *tank = findTankAt(item->data(0).toInt(), item->data(1).toInt());
+                // Por celda y no por item: funciona aunque los tanques estén escondidos por el zoom
+                Tank *tank = findTankAt(row, col);
                 if (tank) {
                     selectedTank = tank;
                     qDebug() << "Tanque seleccionado en (" << tank->getRow() << ", " << tank->getCol() << ")";
@@ -0,0 +1,669 @@
+#ifndef GAMESIMULATION_H
+#define GAMESIMULATION_H
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <QPoint>
+#include "Graph.h"
+#include "Rng.h"
+#include "Pathfinding.h"
+#include "FlowField.h"
+#include "MapGenerator.h"
+#include "HierarchicalPathfinding.h"
+#include "IncrementalPathfinding.h"
+#include "TankRegistry.h"
+#include "Ballistics.h"
+#include "Visibility.h"
+#include "GameState.h"
+#include "Zobrist.h"
+#include "AlphaBetaAi.h"
+#include "MctsAi.h"
+
+/*
+ * Núcleo del juego sin nada de dibujo: mapa, tanques, jugadores, turnos y daño.
+ * Solo depende de Qt Core (QPoint), así que se puede correr sin QApplication.
+ * Todo lo aleatorio sale de generadores sembrados con la semilla de la partida (uno por
+ * subsistema), así que la misma semilla repite la misma partida. La ventana (GameLaunch) se registra como GameObserver
+ * y solo dibuja lo que la simulación le avisa.
+ * Los tanques viven en un TankRegistry (estructura de arreglos); el id de un tanque es su índice
+ * en el registro y TankState es solo una copia para los observadores.
+ */
+
+enum class PathAlgorithm {
+    Bfs,
+    AStar,
+    Hierarchical, // HPA*: casi óptimo, pensado para mapas grandes
+    Incremental   // D* Lite por tanque: repara su búsqueda con los cambios del mapa y esquiva tanques
+                  // (~26 bytes por celda por tanque; solo repara si el destino se repite, si no
+                  // busca de cero). Se elige con setPolicy; no es el de ningún color por defecto
+};
+const int PATH_ALGORITHM_COUNT = 4;
+
+// Con probabilidad pathPercentage % se usa el algoritmo; si no, movimiento aleatorio
+struct MovementPolicy {
+    PathAlgorithm algorithm;
+    int pathPercentage;
+};
+
+// Movimientos de una partida, por algoritmo (índice = PathAlgorithm)
+struct MoveStats {
+    long long pathMoves[PATH_ALGORITHM_COUNT] = {};   // Turnos en que se usó el algoritmo
+    long long unreachable[PATH_ALGORITHM_COUNT] = {}; // De esos, cuántos no encontraron camino
+    long long pathSteps[PATH_ALGORITHM_COUNT] = {};   // Suma de los largos de los caminos encontrados
+    long long randomMoves = 0;
+    long long shots = 0;    // Disparos (también cuentan como turno)
+    long long shotHits = 0; // Disparos que alcanzaron un tanque
+
+    void add(const MoveStats& other) {
+        for (int i = 0; i < PATH_ALGORITHM_COUNT; ++i) {
+            pathMoves[i] += other.pathMoves[i];
+            unreachable[i] += other.unreachable[i];
+            pathSteps[i] += other.pathSteps[i];
+        }
+        randomMoves += other.randomMoves;
+        shots += other.shots;
+        shotHits += other.shotHits;
+    }
+};
+
+// Copia de los datos de un tanque en un momento dado
+struct TankState {
+    int id;
+    int row;
+    int col;
+    TankColor color;
+    int owner; // 0 = jugador 1, 1 = jugador 2
+    int health;
+    int maxHealth;
+
+    bool isDestroyed() const { return health <= 0; }
+};
+
+class GameObserver {
+public:
+    virtual ~GameObserver() = default;
+    virtual void onTankPlaced(const TankState&) {}
+    virtual void onTankMoved(const TankState&, const std::vector<QPoint>&) {}
+    virtual void onTankDamaged(const TankState&, int) {}
+    virtual void onShotFired(const TankState&, const std::vector<QPoint>&, const ShotResult&) {} // Antes de aplicar el daño
+    virtual void onTurnChanged(int) {}
+    virtual void onGameOver(int) {} // Ganador, o -1 si es empate
+};
+
+class GameSimulation {
+public:
+    static const int NUM_PLAYERS = 2;
+    static const int TANKS_PER_COLOR = 2;
+    static const int MAX_HEALTH = 100;
+    static const int DEFAULT_MAX_TURNS = 200;
+    static const int MAX_PLACEMENT_ATTEMPTS = 1000;
+
+    explicit GameSimulation(std::uint64_t seed = Rng::randomSeed(), int numRows = Map::DEFAULT_ROWS, int numCols = Map::DEFAULT_COLS)
+        : gameMap(numRows, numCols), seed(seed),
+          mapRng(Rng::stream(seed, RngStream::Map)), placementRng(Rng::stream(seed, RngStream::Placement)),
+          movementRng(Rng::stream(seed, RngStream::Movement)), aiRng(Rng::stream(seed, RngStream::Ai)),
+          zobrist(numRows, numCols) {
+        policies[static_cast<int>(TankColor::Red)] = {PathAlgorithm::AStar, 80};
+        policies[static_cast<int>(TankColor::Yellow)] = {PathAlgorithm::AStar, 80};
+        policies[static_cast<int>(TankColor::Blue)] = {PathAlgorithm::Bfs, 50};
+        policies[static_cast<int>(TankColor::Cyan)] = {PathAlgorithm::Bfs, 50};
+    }
+
+    void addObserver(GameObserver* observer) {
+        if (observer && std::find(observers.begin(), observers.end(), observer) == observers.end()) {
+            observers.push_back(observer);
+        }
+    }
+
+    void removeObserver(GameObserver* observer) {
+        observers.erase(std::remove(observers.begin(), observers.end(), observer), observers.end());
+    }
+
+    void setPolicy(TankColor color, const MovementPolicy& policy) { policies[static_cast<int>(color)] = policy; }
+    const MovementPolicy& getPolicy(TankColor color) const { return policies[static_cast<int>(color)]; }
+    void setMaxTurns(int turns) { maxTurns = turns; } // 0 = sin límite
+
+    // Paredes sueltas de 2 o 3 celdas como en el juego original (unas 5 en el mapa de 15 x 18)
+    static MapGenOptions defaultMapOptions() { return {MapPattern::Scattered, 5, 2, 3}; }
+
+    // Cómo se generan los obstáculos en setup(); la semilla sale siempre de la partida, no de options.seed
+    void setMapOptions(const MapGenOptions& options) { mapOptions = options; }
+    const MapGenOptions& getMapOptions() const { return mapOptions; }
+
+    // Obstáculos y tanques iniciales; el jugador 1 empieza
+    void setup() {
+        // El generador reescribe el mismo Map en vez de asignar uno nuevo: así las versiones siguen
+        // subiendo y quien guarda datos por versión (cachés, vista, servicio de caminos) ve que todo cambió
+        MapGenerator::generate(gameMap, mapOptions, mapRng);
+        registry.clear();
+        tankByCell.assign(static_cast<std::size_t>(gameMap.getNumCells()), -1);
+        std::fill(std::begin(aliveCount), std::end(aliveCount), 0);
+        flowFields.clear();
+        planner.clear();
+        visibility.clear();
+        moveStats = MoveStats();
+        hash = 0;
+        placeInitialTanks();
+        currentPlayer = 0;
+        turn = 0;
+        winner = -1;
+        gameOver = false;
+        notify([&](GameObserver* o) { o->onTurnChanged(currentPlayer); });
+    }
+
+    const Map& getMap() const { return gameMap; }
+    const TankRegistry& getRegistry() const { return registry; }
+
+    std::vector<TankState> getTanks() const {
+        std::vector<TankState> states;
+        states.reserve(registry.slots());
+        for (std::uint32_t i = 0; i < registry.slots(); ++i) {
+            if (registry.inUse(i)) states.push_back(stateOf(static_cast<int>(i)));
+        }
+        return states;
+    }
+
+    TankState getTank(int tankId) const { return stateOf(tankId); }
+    std::uint64_t getSeed() const { return seed; }
+    int getCurrentPlayer() const { return currentPlayer; }
+    int getTurn() const { return turn; }
+    bool isGameOver() const { return gameOver; }
+    const MoveStats& getMoveStats() const { return moveStats; }
+    int getWinner() const { return winner; }
+
+    // Zobrist de posiciones, vidas y turno (el mismo que calcula GameState), al día después de cada cambio
+    std::uint64_t getHash() const { return hash; }
+
+    bool ownsTank(int player, int tankId) const {
+        return isValidTank(tankId) && registry.team(static_cast<std::uint32_t>(tankId)) == player;
+    }
+
+    // Id del tanque (vivo) en la celda, o -1
+    int tankAt(int row, int col) const {
+        if (!gameMap.isValidIndex(row, col)) return -1;
+        return tankByCell[cellIndex(row, col)];
+    }
+
+    /*
+     * Mover un tanque hacia el destino según su política y pasar el turno.
+     * Devuelve el camino recorrido (vacío si no se movió).
+     */
+    std::vector<QPoint> playTurn(int tankId, int targetRow, int targetCol) {
+        if (gameOver || !isValidTank(tankId) || !registry.isAlive(static_cast<std::uint32_t>(tankId))) return {};
+        std::vector<QPoint> path = planMove(tankId, targetRow, targetCol);
+        applyMove(tankId, path);
+        endTurn();
+        return path;
+    }
+
+    /*
+     * playTurn en dos partes, para buscar el camino fuera del hilo de la ventana: beginMove sortea
+     * con la política y dice qué búsqueda hacer; quien la haga devuelve el camino con finishMove,
+     * que lo aplica y pasa el turno. El sorteo se hace sobre una copia del generador y recién
+     * finishMove lo confirma (y elige el movimiento aleatorio): un plan descartado no consume
+     * números ni cuenta como movimiento aleatorio.
+     * Todo plan que no es aleatorio se busca afuera, también con D* Lite: el planificador de la
+     * simulación es solo para playTurn, que corre en el mismo hilo que la partida.
+     */
+    struct MovePlan {
+        int tankId = -1;
+        int startRow = 0;
+        int startCol = 0;
+        int targetRow = 0;
+        int targetCol = 0;
+        bool needsSearch = false;     // Quien llama tiene que buscar `path` con `algorithm`
+        bool randomMove = false;      // Se sorteó un movimiento aleatorio: finishMove lo elige
+        PathAlgorithm algorithm = PathAlgorithm::Bfs;
+        std::uint64_t obstacleVersion = 0;
+        int turn = 0;
+        std::vector<QPoint> path;
+        Rng movementRng;              // Generador de movimientos después del sorteo
+    };
+
+    bool beginMove(int tankId, int targetRow, int targetCol, MovePlan& plan) {
+        if (gameOver || !isValidTank(tankId) || !registry.isAlive(static_cast<std::uint32_t>(tankId))) return false;
+        const TankState tank = stateOf(tankId);
+        plan = MovePlan();
+        plan.tankId = tankId;
+        plan.startRow = tank.row;
+        plan.startCol = tank.col;
+        plan.targetRow = targetRow;
+        plan.targetCol = targetCol;
+        plan.obstacleVersion = gameMap.getObstacleVersion();
+        plan.turn = turn;
+        const MovementPolicy& policy = getPolicy(tank.color);
+        plan.movementRng = movementRng;
+        if (!plan.movementRng.chance(policy.pathPercentage)) {
+            plan.randomMove = true;
+            return true;
+        }
+        plan.algorithm = policy.algorithm;
+        plan.needsSearch = true;
+        return true;
+    }
+
+    /*
+     * Aplicar un plan con su camino ya buscado. Si mientras tanto pasó un turno, el tanque se movió
+     * o cambiaron los obstáculos, el plan ya no vale: devuelve false y no hace nada.
+     */
+    bool finishMove(MovePlan& plan) {
+        if (gameOver || plan.turn != turn || plan.obstacleVersion != gameMap.getObstacleVersion()) return false;
+        if (!isValidTank(plan.tankId) || !registry.isAlive(static_cast<std::uint32_t>(plan.tankId))) return false;
+        const TankState tank = stateOf(plan.tankId);
+        if (tank.row != plan.startRow || tank.col != plan.startCol) return false;
+        movementRng = plan.movementRng;
+        if (plan.randomMove) {
+            ++moveStats.randomMoves;
+            plan.path = Pathfinding::randomMove(gameMap, tank.row, tank.col, movementRng);
+        } else {
+            recordPath(plan.algorithm, plan.path);
+        }
+        applyMove(plan.tankId, plan.path);
+        endTurn();
+        return true;
+    }
+
+    /*
+     * Disparar con un tanque hacia una celda y pasar el turno. El proyectil daña al primer
+     * tanque que encuentra, sea de quien sea.
+     */
+    ShotResult fire(int tankId, int targetRow, int targetCol, ProjectileType type = ProjectileType::Standard) {
+        if (gameOver || !isValidTank(tankId) || !registry.isAlive(static_cast<std::uint32_t>(tankId))) return {};
+        std::uint32_t index = static_cast<std::uint32_t>(tankId);
+        Shot shot{registry.row(index), registry.col(index), targetRow, targetCol, Projectile::of(type), tankId};
+        std::vector<QPoint> path;
+        ShotResult result = Ballistics::trace(gameMap, tankByCell.data(), shot, &path);
+        ++moveStats.shots;
+        TankState shooter = stateOf(tankId);
+        notify([&](GameObserver* o) { o->onShotFired(shooter, path, result); });
+        if (result.hit()) {
+            ++moveStats.shotHits;
+            applyDamage(result.tankId, shot.projectile.damage);
+        }
+        endTurn();
+        return result;
+    }
+
+    /*
+     * Mover un tanque por el camino más corto (BFS) hasta la celda y pasar el turno, sin sortear
+     * algoritmo. Lo usan las IAs de búsqueda, que necesitan que la jugada haga lo que planearon.
+     */
+    std::vector<QPoint> moveTo(int tankId, int targetRow, int targetCol) {
+        if (gameOver || !isValidTank(tankId) || !registry.isAlive(static_cast<std::uint32_t>(tankId))) return {};
+        std::uint32_t index = static_cast<std::uint32_t>(tankId);
+        std::vector<QPoint> path = flowFields.path(gameMap, registry.row(index), registry.col(index), targetRow, targetCol);
+        applyMove(tankId, path);
+        endTurn();
+        return path;
+    }
+
+    // Copia compacta de la partida para las búsquedas (índice en el estado -> id con TankSlot::id)
+    GameState snapshot() const {
+        GameState state;
+        for (std::uint32_t i = 0; i < registry.slots() && state.numTanks < GameState::MAX_TANKS; ++i) {
+            if (!registry.inUse(i)) continue;
+            state.tanks[state.numTanks++] = {static_cast<std::int16_t>(registry.row(i)), static_cast<std::int16_t>(registry.col(i)),
+                                             static_cast<std::int16_t>(registry.healthOf(i)), static_cast<std::uint8_t>(registry.team(i)),
+                                             static_cast<std::uint8_t>(i)};
+        }
+        state.currentPlayer = static_cast<std::uint8_t>(currentPlayer);
+        state.hash = hash; // Los índices del estado coinciden con los del registro: nunca se quitan tanques
+        return state;
+    }
+
+    // Jugar una jugada de GameState (índices del estado devuelto por snapshot())
+    void playAiMove(const GameState& state, const AiMove& move) {
+        int tankId = state.tanks[move.tank].id;
+        if (move.kind == AiMoveKind::Move) {
+            moveTo(tankId, move.row, move.col);
+        } else if (move.kind == AiMoveKind::Fire) {
+            fire(tankId, move.row, move.col, move.projectile);
+        } else if (!gameOver) {
+            endTurn();
+        }
+    }
+
+    // Turno del jugador actual decidido con alfa-beta
+    AlphaBetaAi::Result playSearchTurn(AlphaBetaAi& ai) {
+        GameState state = snapshot();
+        AlphaBetaAi::Result result = ai.search(gameMap, state);
+        playAiMove(state, result.move);
+        return result;
+    }
+
+    // Turno del jugador actual decidido con Monte Carlo
+    MctsAi::Result playSearchTurn(MctsAi& ai) {
+        GameState state = snapshot();
+        MctsAi::Result result = ai.search(gameMap, state);
+        playAiMove(state, result.move);
+        return result;
+    }
+
+    // Visibilidad entre celdas (simétrica); se guarda por celda y se actualiza sola con los obstáculos
+    bool canSee(int fromRow, int fromCol, int toRow, int toCol) {
+        return visibility.canSee(gameMap, fromRow, fromCol, toRow, toCol);
+    }
+
+    const VisibilityMask& visibleFrom(int row, int col) { return visibility.visibleFrom(gameMap, row, col); }
+
+    // Trazar disparos sin jugarlos (para evaluar opciones); un resultado por disparo
+    void traceShots(const std::vector<Shot>& shots, std::vector<ShotResult>& results) const {
+        Ballistics::traceBatch(gameMap, tankByCell.data(), shots, results);
+    }
+
+    /*
+     * Turno automático: se elige un tanque vivo al azar del jugador actual; si alguno de sus
+     * disparos posibles alcanza a un enemigo dispara, y si no se mueve hacia una celda libre al azar.
+     */
+    std::vector<QPoint> playRandomTurn() {
+        std::vector<int> candidates;
+        registry.forEachAlive([&](std::uint32_t i) {
+            if (registry.team(i) == currentPlayer) candidates.push_back(static_cast<int>(i));
+        });
+        if (candidates.empty()) {
+            endTurn();
+            return {};
+        }
+        int tankId = candidates[aiRng.bounded(static_cast<int>(candidates.size()))];
+        const Shot* shot = chooseShot(tankId);
+        if (shot) {
+            fire(tankId, shot->targetRow, shot->targetCol, shot->projectile.type);
+            return {};
+        }
+        int row, col;
+        do {
+            row = aiRng.bounded(gameMap.getNumRows());
+            col = aiRng.bounded(gameMap.getNumCols());
+        } while (gameMap.isObstacle(row, col));
+        return playTurn(tankId, row, col);
+    }
+
+    void applyDamage(int tankId, int damage) {
+        if (!isValidTank(tankId) || damage <= 0) return;
+        std::uint32_t index = static_cast<std::uint32_t>(tankId);
+        if (!registry.isAlive(index)) return;
+        int healthBefore = registry.healthOf(index);
+        if (registry.damage(index, damage)) releaseCell(index);
+        hashHealth(index, healthBefore);
+        hashHealth(index, registry.healthOf(index));
+        TankState tank = stateOf(tankId);
+        notify([&](GameObserver* o) { o->onTankDamaged(tank, damage); });
+        checkGameOver();
+    }
+
+    /*
+     * Daño a todos los tanques vivos a distancia Manhattan <= radius de la celda, de cualquier
+     * jugador. Se resuelve en una sola pasada sobre el registro; devuelve cuántos tanques recibieron daño.
+     */
+    int applyAreaDamage(int row, int col, int radius, int damage) {
+        if (damage <= 0 || radius < 0) return 0;
+        std::vector<int> before(registry.slots());
+        for (std::uint32_t i = 0; i < registry.slots(); ++i) before[i] = registry.healthOf(i);
+        std::vector<std::uint32_t> destroyed;
+        int hits = registry.applyAreaDamage(row, col, radius, damage, &destroyed);
+        for (std::uint32_t index : destroyed) releaseCell(index);
+        for (std::uint32_t i = 0; i < registry.slots(); ++i) {
+            int taken = before[i] - registry.healthOf(i);
+            if (taken <= 0) continue;
+            hashHealth(i, before[i]);
+            hashHealth(i, registry.healthOf(i));
+            TankState tank = stateOf(static_cast<int>(i));
+            notify([&](GameObserver* o) { o->onTankDamaged(tank, taken); });
+        }
+        checkGameOver();
+        return hits;
+    }
+
+    int aliveTanks(int player) const {
+        return player >= 0 && player < NUM_PLAYERS ? aliveCount[player] : 0;
+    }
+
+    int totalHealth(int player) const {
+        return registry.totalHealth(player);
+    }
+
+private:
+    Map gameMap;
+    std::uint64_t seed;
+    Rng mapRng;
+    Rng placementRng;
+    Rng movementRng;
+    Rng aiRng;
+    ZobristKeys zobrist;
+    std::uint64_t hash = 0;
+    TankRegistry registry; // Tanques como estructura de arreglos; id = índice
+    std::vector<GameObserver*> observers;
+    MovementPolicy policies[4];
+    FlowFieldCache flowFields; // Campos de flujo por destino, compartidos por todos los tanques
+    HierarchicalPathfinder hierarchical; // Se pone al día solo con el registro de cambios del mapa
+    IncrementalPlanner planner;          // D* Lite por id de tanque, conservado entre turnos
+    VisibilityCache visibility;
+    MoveStats moveStats;
+    std::vector<int> tankByCell;          // Celda -> id del tanque vivo que la ocupa, o -1
+    std::vector<Shot> candidateShots;     // Se reutilizan entre turnos de la IA
+    std::vector<ShotResult> candidateResults;
+    int aliveCount[NUM_PLAYERS] = {0, 0}; // Tanques vivos por jugador
+    int currentPlayer = 0;
+    int turn = 0;
+    int maxTurns = DEFAULT_MAX_TURNS;
+    MapGenOptions mapOptions = defaultMapOptions();
+    int winner = -1;
+    bool gameOver = false;
+
+    template <typename Fn>
+    void notify(Fn fn) {
+        for (GameObserver* observer : observers) fn(observer);
+    }
+
+    int cellIndex(int row, int col) const { return row * gameMap.getNumCols() + col; }
+
+    bool isValidTank(int tankId) const {
+        return tankId >= 0 && static_cast<std::size_t>(tankId) < registry.slots() && registry.inUse(static_cast<std::uint32_t>(tankId));
+    }
+
+    TankState stateOf(int tankId) const {
+        std::uint32_t i = static_cast<std::uint32_t>(tankId);
+        return {tankId, registry.row(i), registry.col(i), registry.color(i), registry.team(i), registry.healthOf(i), registry.maxHealthOf(i)};
+    }
+
+    void hashPosition(std::uint32_t index, int row, int col) {
+        if (index < ZobristKeys::MAX_TANKS) hash ^= zobrist.position(static_cast<int>(index), row, col);
+    }
+
+    void hashHealth(std::uint32_t index, int health) {
+        if (index < ZobristKeys::MAX_TANKS) hash ^= zobrist.health(static_cast<int>(index), health);
+    }
+
+    // Un tanque destruido deja libre su celda
+    void releaseCell(std::uint32_t index) {
+        int row = registry.row(index);
+        int col = registry.col(index);
+        tankByCell[cellIndex(row, col)] = -1;
+        gameMap.removeEdge(row, col);
+        --aliveCount[registry.team(index)];
+        planner.forget(static_cast<int>(index));
+    }
+
+    static int ownerOf(TankColor color) {
+        return (color == TankColor::Red || color == TankColor::Blue) ? 0 : 1;
+    }
+
+    void placeTank(TankColor color, int minCol, int maxCol) {
+        int row = -1;
+        int col = -1;
+        for (int attempt = 0; attempt < MAX_PLACEMENT_ATTEMPTS; ++attempt) {
+            int r = placementRng.bounded(gameMap.getNumRows());
+            int c = placementRng.bounded(minCol, maxCol); // Se limitan las columnas
+            if (!gameMap.isOccupied(r, c)) {
+                row = r;
+                col = c;
+                break;
+            }
+        }
+        // Con mapas generados muy densos las columnas pueden estar casi llenas: primera celda libre
+        if (row < 0 && !findFreeCell(minCol, maxCol, row, col) && !findFreeCell(0, gameMap.getNumCols(), row, col)) {
+            return;
+        }
+
+        TankHandle handle = registry.add(row, col, color, ownerOf(color), MAX_HEALTH);
+        TankState tank = stateOf(static_cast<int>(handle.index));
+        tankByCell[cellIndex(row, col)] = tank.id;
+        hashPosition(handle.index, row, col);
+        hashHealth(handle.index, tank.health);
+        ++aliveCount[tank.owner];
+        gameMap.addEdge(row, col); // Marca la celda como ocupada
+        notify([&](GameObserver* o) { o->onTankPlaced(tank); });
+    }
+
+    bool findFreeCell(int minCol, int maxCol, int& row, int& col) const {
+        for (int c = minCol; c < maxCol; ++c) {
+            for (int r = 0; r < gameMap.getNumRows(); ++r) {
+                if (!gameMap.isOccupied(r, c)) {
+                    row = r;
+                    col = c;
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    // Rojos y azules en las dos primeras columnas, amarillos y celestes en las dos últimas
+    void placeInitialTanks() {
+        int numCols = gameMap.getNumCols();
+        for (int i = 0; i < TANKS_PER_COLOR; ++i) placeTank(TankColor::Red, 0, 2);
+        for (int i = 0; i < TANKS_PER_COLOR; ++i) placeTank(TankColor::Blue, 0, 2);
+        for (int i = 0; i < TANKS_PER_COLOR; ++i) placeTank(TankColor::Yellow, numCols - 2, numCols);
+        for (int i = 0; i < TANKS_PER_COLOR; ++i) placeTank(TankColor::Cyan, numCols - 2, numCols);
+    }
+
+    std::vector<QPoint> planMove(int tankId, int targetRow, int targetCol) {
+        const TankState tank = stateOf(tankId);
+        const MovementPolicy& policy = getPolicy(tank.color);
+        if (!movementRng.chance(policy.pathPercentage)) {
+            ++moveStats.randomMoves;
+            return Pathfinding::randomMove(gameMap, tank.row, tank.col, movementRng);
+        }
+
+        std::vector<QPoint> path;
+        if (policy.algorithm == PathAlgorithm::Bfs) {
+            // Mismo largo que bfsPath; el campo se reutiliza mientras no cambien los obstáculos
+            path = flowFields.path(gameMap, tank.row, tank.col, targetRow, targetCol);
+        } else if (policy.algorithm == PathAlgorithm::Hierarchical) {
+            path = hierarchical.findPath(gameMap, tank.row, tank.col, targetRow, targetCol);
+        } else if (policy.algorithm == PathAlgorithm::Incremental) {
+            path = planner.plan(gameMap, tankId, tank.row, tank.col, targetRow, targetCol);
+        } else {
+            path = Pathfinding::astarPath(gameMap, tank.row, tank.col, targetRow, targetCol);
+        }
+        recordPath(policy.algorithm, path);
+        return path;
+    }
+
+    void recordPath(PathAlgorithm algorithm, const std::vector<QPoint>& path) {
+        int index = static_cast<int>(algorithm);
+        ++moveStats.pathMoves[index];
+        if (path.empty()) {
+            ++moveStats.unreachable[index];
+        } else {
+            moveStats.pathSteps[index] += static_cast<long long>(path.size()) - 1;
+        }
+    }
+
+    /*
+     * Los caminos solo esquivan obstáculos, así que se puede pasar por encima de otros tanques,
+     * pero no terminar encima de uno: el camino se corta antes de la primera celda final ocupada.
+     * Solo cambian la celda de salida y la de llegada, así el índice de ocupación sigue exacto.
+     */
+    void applyMove(int tankId, std::vector<QPoint>& path) {
+        std::uint32_t index = static_cast<std::uint32_t>(tankId);
+        while (path.size() > 1) {
+            int occupant = tankAt(path.back().x(), path.back().y());
+            if (occupant < 0 || occupant == tankId) break;
+            path.pop_back();
+        }
+        int row = registry.row(index);
+        int col = registry.col(index);
+        if (!path.empty() && (path.back().x() != row || path.back().y() != col)) {
+            tankByCell[cellIndex(row, col)] = -1;
+            gameMap.removeEdge(row, col);
+            registry.setPosition(index, path.back().x(), path.back().y());
+            hashPosition(index, row, col);
+            hashPosition(index, path.back().x(), path.back().y());
+            tankByCell[cellIndex(path.back().x(), path.back().y())] = tankId;
+            gameMap.addEdge(path.back().x(), path.back().y());
+        }
+        TankState tank = stateOf(tankId);
+        notify([&](GameObserver* o) { o->onTankMoved(tank, path); });
+    }
+
+    /*
+     * Disparos que prueba la IA: cada tipo de proyectil hacia cada enemigo vivo, y rebotes hacia
+     * cada celda del borde. Se trazan todos juntos y gana el de más daño que alcance a un enemigo.
+     */
+    const Shot* chooseShot(int tankId) {
+        std::uint32_t index = static_cast<std::uint32_t>(tankId);
+        int row = registry.row(index);
+        int col = registry.col(index);
+        int team = registry.team(index);
+        candidateShots.clear();
+        registry.forEachAlive([&](std::uint32_t i) {
+            if (registry.team(i) == team) return;
+            for (ProjectileType type : {ProjectileType::Standard, ProjectileType::Piercing, ProjectileType::Bouncing}) {
+                candidateShots.push_back({row, col, registry.row(i), registry.col(i), Projectile::of(type), tankId});
+            }
+        });
+        if (candidateShots.empty()) return nullptr;
+        Projectile bouncing = Projectile::of(ProjectileType::Bouncing);
+        int lastRow = gameMap.getNumRows() - 1;
+        int lastCol = gameMap.getNumCols() - 1;
+        for (int c = 0; c <= lastCol; ++c) {
+            candidateShots.push_back({row, col, 0, c, bouncing, tankId});
+            candidateShots.push_back({row, col, lastRow, c, bouncing, tankId});
+        }
+        for (int r = 1; r < lastRow; ++r) {
+            candidateShots.push_back({row, col, r, 0, bouncing, tankId});
+            candidateShots.push_back({row, col, r, lastCol, bouncing, tankId});
+        }
+
+        traceShots(candidateShots, candidateResults);
+        const Shot* best = nullptr;
+        for (std::size_t k = 0; k < candidateShots.size(); ++k) {
+            const ShotResult& result = candidateResults[k];
+            if (!result.hit() || registry.team(static_cast<std::uint32_t>(result.tankId)) == team) continue;
+            if (!best || candidateShots[k].projectile.damage > best->projectile.damage) best = &candidateShots[k];
+        }
+        return best;
+    }
+
+    void endTurn() {
+        ++turn;
+        currentPlayer = (currentPlayer + 1) % NUM_PLAYERS;
+        hash ^= zobrist.sideToMove();
+        notify([&](GameObserver* o) { o->onTurnChanged(currentPlayer); });
+        checkGameOver();
+    }
+
+    // Gana quien deja al otro sin tanques; al llegar al límite de turnos, quien tenga más vida
+    void checkGameOver() {
+        if (gameOver || registry.size() == 0) return;
+        int alive0 = aliveTanks(0);
+        int alive1 = aliveTanks(1);
+        if (alive0 > 0 && alive1 > 0 && (maxTurns <= 0 || turn < maxTurns)) return;
+
+        if (alive0 == 0 && alive1 == 0) {
+            winner = -1;
+        } else if (alive0 == 0 || alive1 == 0) {
+            winner = alive0 == 0 ? 1 : 0;
+        } else {
+            int health0 = totalHealth(0);
+            int health1 = totalHealth(1);
+            winner = health0 == health1 ? -1 : (health0 > health1 ? 0 : 1);
+        }
+        gameOver = true;
+        notify([&](GameObserver* o) { o->onGameOver(winner); });
+    }
+};
+
+#endif // GAMESIMULATION_H
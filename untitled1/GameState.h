@@ -0,0 +1,534 @@
+#ifndef GAMESTATE_H
+#define GAMESTATE_H
+
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <climits>
+#include <algorithm>
+#include <QPoint>
+#include "Graph.h"
+#include "Ballistics.h"
+#include "Rng.h"
+#include "Zobrist.h"
+
+/*
+ * Estado de una partida reducido a lo que cambia de un turno a otro: posición y vida de cada
+ * tanque y el jugador que mueve. Son unos pocos bytes sin punteros, así que copiarlo es barato;
+ * las búsquedas de la IA crean un hijo copiando al padre y aplicando una jugada.
+ * El mapa no va adentro: los obstáculos no cambian durante una búsqueda y se comparten.
+ * `hash` es el Zobrist de la posición (ZobristKeys); GameStateRules::apply lo mantiene al día.
+ */
+
+enum class AiMoveKind : std::uint8_t { Move, Fire, Pass };
+
+struct AiMove {
+    AiMoveKind kind = AiMoveKind::Pass;
+    std::uint8_t tank = 0;
+    std::int16_t row = 0; // Destino (Move) o celda a la que se apunta (Fire)
+    std::int16_t col = 0;
+    ProjectileType projectile = ProjectileType::Standard;
+
+    bool operator==(const AiMove& other) const {
+        return kind == other.kind && tank == other.tank && row == other.row && col == other.col && projectile == other.projectile;
+    }
+};
+
+struct GameState {
+    static const int MAX_TANKS = 16;
+    static const int NUM_PLAYERS = 2;
+
+    struct TankSlot {
+        std::int16_t row;
+        std::int16_t col;
+        std::int16_t health;
+        std::uint8_t team;
+        std::uint8_t id; // Id del tanque en GameSimulation
+    };
+
+    TankSlot tanks[MAX_TANKS];
+    std::uint8_t numTanks = 0;
+    std::uint8_t currentPlayer = 0;
+    std::uint64_t hash = 0;
+
+    bool isAlive(int i) const { return tanks[i].health > 0; }
+
+    int aliveCount(int team) const {
+        int total = 0;
+        for (int i = 0; i < numTanks; ++i) total += (tanks[i].team == team) & (tanks[i].health > 0);
+        return total;
+    }
+
+    int totalHealth(int team) const {
+        int total = 0;
+        for (int i = 0; i < numTanks; ++i) total += tanks[i].team == team ? tanks[i].health : 0;
+        return total;
+    }
+
+    // Termina cuando un jugador se queda sin tanques
+    bool isTerminal() const { return aliveCount(0) == 0 || aliveCount(1) == 0; }
+
+    // Hash calculado desde cero (el índice en `tanks` es el índice de la clave)
+    std::uint64_t computeHash(const ZobristKeys& keys) const {
+        std::uint64_t value = currentPlayer == 1 ? keys.sideToMove() : 0;
+        for (int i = 0; i < numTanks; ++i) {
+            value ^= keys.position(i, tanks[i].row, tanks[i].col) ^ keys.health(i, tanks[i].health);
+        }
+        return value;
+    }
+};
+
+static_assert(GameState::MAX_TANKS <= ZobristKeys::MAX_TANKS, "Faltan claves de Zobrist para los tanques");
+
+/*
+ * Reglas del juego sobre GameState para las búsquedas: qué jugadas hay y qué hacen. Mantiene la
+ * ocupación del mapa (celda -> índice del tanque en el estado) para trazar los disparos igual que
+ * GameSimulation; apply() la actualiza y undo() la devuelve al estado anterior.
+ *
+ * Las jugadas son: mover un tanque a una celda libre a moveRadius pasos o menos (el camino más
+ * corto solo esquiva obstáculos, como el BFS de la simulación), disparar cuando el proyectil
+ * alcanza a un enemigo (los mismos disparos que prueba el jugador automático de la simulación,
+ * uno por objetivo) o pasar si el jugador no tiene ninguna otra.
+ */
+class GameStateRules {
+public:
+    static const int DEFAULT_MOVE_RADIUS = 3;
+
+    explicit GameStateRules(const Map& gameMap, int moveRadius = DEFAULT_MOVE_RADIUS)
+        : gameMap(gameMap), rows(gameMap.getNumRows()), cols(gameMap.getNumCols()), moveRadius(moveRadius),
+          occupancy(static_cast<std::size_t>(gameMap.getNumCells()), -1),
+          visitStamp(static_cast<std::size_t>(gameMap.getNumCells()), 0), keys(rows, cols),
+          bounceOffset(static_cast<std::size_t>(gameMap.getNumCells()), -1) {
+        for (int r = 0; r < rows; ++r) {
+            for (int c = 0; c < cols; ++c) {
+                if (gameMap.cellAt(r, c) == Map::OBSTACLE) mapHash ^= keys.obstacle(r, c);
+            }
+        }
+        for (int c = 0; c < cols; ++c) {
+            borderTargets.push_back(QPoint(0, c));
+            borderTargets.push_back(QPoint(rows - 1, c));
+        }
+        for (int r = 1; r < rows - 1; ++r) {
+            borderTargets.push_back(QPoint(r, 0));
+            borderTargets.push_back(QPoint(r, cols - 1));
+        }
+    }
+
+    const Map& getMap() const { return gameMap; }
+    const ZobristKeys& getKeys() const { return keys; }
+
+    // Clave de la posición en este mapa: el hash del estado con los obstáculos mezclados
+    std::uint64_t positionKey(const GameState& state) const { return state.hash ^ mapHash; }
+
+    // Rehacer la ocupación para empezar a buscar desde `state`
+    void bind(const GameState& state) {
+        std::fill(occupancy.begin(), occupancy.end(), -1);
+        for (int i = 0; i < state.numTanks; ++i) {
+            if (state.isAlive(i)) occupancy[cell(state.tanks[i].row, state.tanks[i].col)] = i;
+        }
+    }
+
+    void generate(const GameState& state, std::vector<AiMove>& out) {
+        out.clear();
+        for (int i = 0; i < state.numTanks; ++i) {
+            if (state.tanks[i].team != state.currentPlayer || !state.isAlive(i)) continue;
+            generateFires(state, i, out);
+        }
+        for (int i = 0; i < state.numTanks; ++i) {
+            if (state.tanks[i].team != state.currentPlayer || !state.isAlive(i)) continue;
+            generateMoves(state, i, out);
+        }
+        if (out.empty()) out.push_back(AiMove());
+    }
+
+    /*
+     * Jugada barata para las simulaciones al azar: un tanque vivo al azar del jugador; si algún
+     * disparo directo suyo alcanza a un enemigo hace el de más daño, y si no da un paso a una celda
+     * vecina libre al azar (como Pathfinding::randomMove). Pasa si no tiene tanques o no se puede mover.
+     */
+    AiMove randomMove(const GameState& state, Rng& rng) {
+        int candidates[GameState::MAX_TANKS];
+        int count = 0;
+        for (int i = 0; i < state.numTanks; ++i) {
+            if (state.tanks[i].team == state.currentPlayer && state.isAlive(i)) candidates[count++] = i;
+        }
+        if (count == 0) return AiMove();
+        int i = candidates[rng.bounded(count)];
+        const GameState::TankSlot& tank = state.tanks[i];
+
+        AiMove fire;
+        int bestDamage = 0;
+        for (int j = 0; j < state.numTanks; ++j) {
+            const GameState::TankSlot& enemy = state.tanks[j];
+            if (enemy.team == tank.team || enemy.health <= 0) continue;
+            for (ProjectileType type : {ProjectileType::Standard, ProjectileType::Bouncing, ProjectileType::Piercing}) {
+                Projectile projectile = Projectile::of(type);
+                if (projectile.damage <= bestDamage) continue;
+                int hit = firstTankHit(i, tank.row, tank.col, enemy.row, enemy.col, type);
+                if (hit >= 0 && state.tanks[hit].team != tank.team) {
+                    fire = {AiMoveKind::Fire, static_cast<std::uint8_t>(i), enemy.row, enemy.col, type};
+                    bestDamage = projectile.damage;
+                }
+            }
+        }
+        if (bestDamage > 0) return fire;
+
+        static const int STEPS[4][2] = {{0, 1}, {1, 0}, {0, -1}, {-1, 0}};
+        int first = rng.bounded(4);
+        for (int k = 0; k < 4; ++k) {
+            int nr = tank.row + STEPS[(first + k) % 4][0];
+            int nc = tank.col + STEPS[(first + k) % 4][1];
+            if (nr < 0 || nr >= rows || nc < 0 || nc >= cols) continue;
+            if (gameMap.cellAt(nr, nc) == Map::OBSTACLE || occupancy[cell(nr, nc)] >= 0) continue;
+            return {AiMoveKind::Move, static_cast<std::uint8_t>(i), static_cast<std::int16_t>(nr), static_cast<std::int16_t>(nc),
+                    ProjectileType::Standard};
+        }
+        return AiMove();
+    }
+
+    // Jugar `move` sobre `state` (y la ocupación) y pasar el turno; devuelve el daño causado
+    int apply(GameState& state, const AiMove& move) {
+        int damage = 0;
+        GameState::TankSlot& tank = state.tanks[move.tank];
+        if (move.kind == AiMoveKind::Move) {
+            occupancy[cell(tank.row, tank.col)] = -1;
+            state.hash ^= keys.position(move.tank, tank.row, tank.col) ^ keys.position(move.tank, move.row, move.col);
+            tank.row = move.row;
+            tank.col = move.col;
+            occupancy[cell(tank.row, tank.col)] = move.tank;
+        } else if (move.kind == AiMoveKind::Fire) {
+            Projectile projectile = Projectile::of(move.projectile);
+            int hit = firstTankHit(move.tank, tank.row, tank.col, move.row, move.col, move.projectile);
+            if (hit >= 0) {
+                GameState::TankSlot& target = state.tanks[hit];
+                damage = std::min<int>(target.health, projectile.damage);
+                state.hash ^= keys.health(hit, target.health) ^ keys.health(hit, target.health - damage);
+                target.health = static_cast<std::int16_t>(target.health - damage);
+                if (target.health <= 0) occupancy[cell(target.row, target.col)] = -1;
+            }
+        }
+        state.currentPlayer = static_cast<std::uint8_t>(1 - state.currentPlayer);
+        state.hash ^= keys.sideToMove();
+        return damage;
+    }
+
+    // Deshacer en la ocupación lo que cambió de `before` a `after`
+    void undo(const GameState& before, const GameState& after) {
+        for (int i = 0; i < before.numTanks; ++i) {
+            const GameState::TankSlot& a = after.tanks[i];
+            const GameState::TankSlot& b = before.tanks[i];
+            if (a.row == b.row && a.col == b.col && a.health == b.health) continue;
+            if (a.health > 0) occupancy[cell(a.row, a.col)] = -1;
+            if (b.health > 0) occupancy[cell(b.row, b.col)] = i;
+        }
+    }
+
+    /*
+     * Puntaje para el jugador que mueve: vida y tanques vivos de cada lado, y un poco por estar
+     * más cerca del enemigo que él de uno (para que la IA se acerque en vez de esperar).
+     */
+    int evaluate(const GameState& state) const {
+        int player = state.currentPlayer;
+        int score = 0;
+        for (int i = 0; i < state.numTanks; ++i) {
+            const GameState::TankSlot& tank = state.tanks[i];
+            if (tank.health <= 0) continue;
+            int sign = tank.team == player ? 1 : -1;
+            score += sign * (tank.health + ALIVE_BONUS);
+            score -= sign * nearestEnemyDistance(state, i);
+        }
+        return score;
+    }
+
+    // Distancia Manhattan al enemigo vivo más cercano (0 si no queda ninguno)
+    static int nearestEnemyDistance(const GameState& state, int i) {
+        return nearestEnemyDistance(state, state.tanks[i].team, state.tanks[i].row, state.tanks[i].col);
+    }
+
+    // Lo mismo para un tanque de `team` puesto en (row, col), sin copiar el estado
+    static int nearestEnemyDistance(const GameState& state, int team, int row, int col) {
+        int best = 0;
+        bool found = false;
+        for (int j = 0; j < state.numTanks; ++j) {
+            if (state.tanks[j].team == team || state.tanks[j].health <= 0) continue;
+            int distance = std::abs(state.tanks[j].row - row) + std::abs(state.tanks[j].col - col);
+            if (!found || distance < best) best = distance;
+            found = true;
+        }
+        return best;
+    }
+
+private:
+    static const int ALIVE_BONUS = 50;
+    static const std::size_t MAX_BOUNCE_CACHE = std::size_t(1) << 22;     // Enteros guardados como máximo (16 MB)
+    static const std::size_t MAX_TRAJECTORY_CACHE = std::size_t(1) << 22;
+
+    const Map& gameMap;
+    int rows;
+    int cols;
+    int moveRadius;
+    std::vector<int> occupancy;
+    std::vector<std::uint32_t> visitStamp;
+    std::uint32_t stamp = 0;
+    std::vector<int> frontier;
+    std::vector<Shot> shots;
+    std::vector<ShotResult> results;
+    ZobristKeys keys;
+    std::uint64_t mapHash = 0;
+    // Rebotes hacia el borde, en el orden en que se prueban, e índice por celda de salida ya usada
+    std::vector<QPoint> borderTargets;
+    std::vector<int> bounceOffset; // Por celda de salida: dónde empieza su bloque en bounceIndex, o -1
+    std::vector<int> bounceIndex;
+    std::vector<int> rayStep; // Paso del primer tanque en cada rayo (INT_MAX si ninguno)
+    std::vector<int> rayTank;
+    std::vector<int> touchedRays;
+    // Recorridos de disparos sueltos: tabla abierta de (salida, objetivo, tipo) -> posición en trajectories
+    std::vector<std::uint64_t> trajectoryKeys;
+    std::vector<int> trajectoryStart;
+    std::vector<int> trajectories;
+    std::size_t trajectoryCount = 0;
+    std::vector<QPoint> tracedPath;
+
+    int cell(int row, int col) const { return row * cols + col; }
+
+    /*
+     * Disparos de un tanque: cada tipo de proyectil hacia cada enemigo y rebotes hacia cada celda
+     * del borde. Por cada enemigo alcanzado queda solo el disparo de más daño (con empate, el primero).
+     *
+     * Si el disparo normal hacia un enemigo choca con un tanque, el perforante y el de rebote van por
+     * las mismas celdas, chocan con el mismo y hacen menos daño, así que no se prueban. Los rebotes
+     * hacia el borde son la mayor parte (2 * (filas + columnas) rayos por tanque) y no dependen de
+     * los tanques hasta que chocan con uno: se usan los rayos guardados de la celda de salida
+     * (cachedBounces) y se miran solo las celdas donde hay tanques.
+     */
+    void generateFires(const GameState& state, int shooter, std::vector<AiMove>& out) {
+        const GameState::TankSlot& tank = state.tanks[shooter];
+        int bestDamage[GameState::MAX_TANKS] = {};
+        AiMove best[GameState::MAX_TANKS];
+        auto consider = [&](int target, int targetRow, int targetCol, const Projectile& projectile) {
+            if (target < 0 || state.tanks[target].team == tank.team || projectile.damage <= bestDamage[target]) return;
+            bestDamage[target] = projectile.damage;
+            best[target] = {AiMoveKind::Fire, static_cast<std::uint8_t>(shooter), static_cast<std::int16_t>(targetRow),
+                            static_cast<std::int16_t>(targetCol), projectile.type};
+        };
+
+        bool anyEnemy = false;
+        for (int j = 0; j < state.numTanks; ++j) {
+            const GameState::TankSlot& enemy = state.tanks[j];
+            if (enemy.team == tank.team || enemy.health <= 0) continue;
+            anyEnemy = true;
+            for (ProjectileType type : {ProjectileType::Standard, ProjectileType::Piercing, ProjectileType::Bouncing}) {
+                int hit = firstTankHit(shooter, tank.row, tank.col, enemy.row, enemy.col, type);
+                consider(hit, enemy.row, enemy.col, Projectile::of(type));
+                if (hit >= 0 && type == ProjectileType::Standard) break;
+            }
+        }
+        if (!anyEnemy) return;
+
+        Projectile bouncing = Projectile::of(ProjectileType::Bouncing);
+        bool useful = false; // Algún enemigo todavía no recibe un disparo directo de más daño que un rebote
+        for (int j = 0; j < state.numTanks; ++j) {
+            const GameState::TankSlot& enemy = state.tanks[j];
+            useful |= enemy.team != tank.team && enemy.health > 0 && bestDamage[j] < bouncing.damage;
+        }
+        int offset = useful ? cachedBounces(tank.row, tank.col) : -1;
+        if (offset >= 0) {
+            // Para cada rayo, el primer tanque de su recorrido: se recorren las entradas de cada celda con tanque
+            touchedRays.clear();
+            const int* index = bounceIndex.data() + offset;
+            for (int j = 0; j < state.numTanks; ++j) {
+                if (j == shooter || state.tanks[j].health <= 0) continue;
+                int at = cell(state.tanks[j].row, state.tanks[j].col);
+                for (int e = index[at]; e < index[at + 1]; e += 2) {
+                    int ray = index[e];
+                    int step = index[e + 1];
+                    if (rayStep[ray] == INT_MAX) touchedRays.push_back(ray);
+                    if (step < rayStep[ray]) {
+                        rayStep[ray] = step;
+                        rayTank[ray] = j;
+                    }
+                }
+            }
+            // Entre rebotes el daño es el mismo: gana el primer rayo (en el orden del borde) que alcanza a cada uno
+            std::sort(touchedRays.begin(), touchedRays.end());
+            for (int ray : touchedRays) {
+                consider(rayTank[ray], borderTargets[ray].x(), borderTargets[ray].y(), bouncing);
+                rayStep[ray] = INT_MAX;
+            }
+        } else if (useful) {
+            shots.clear();
+            for (const QPoint& target : borderTargets) {
+                shots.push_back({tank.row, tank.col, target.x(), target.y(), bouncing, shooter});
+            }
+            Ballistics::traceBatch(gameMap, occupancy.data(), shots, results);
+            for (std::size_t k = 0; k < shots.size(); ++k) {
+                consider(results[k].tankId, shots[k].targetRow, shots[k].targetCol, bouncing);
+            }
+        }
+
+        for (int j = 0; j < state.numTanks; ++j) {
+            if (bestDamage[j] > 0) out.push_back(best[j]);
+        }
+    }
+
+    /*
+     * Tanque (índice en el estado) que alcanza un disparo, o -1. El recorrido sin tanques de cada
+     * disparo se calcula una vez y se guarda (el mapa no cambia durante la búsqueda); con tanques,
+     * el proyectil se detiene en el primero que pisa, así que basta con buscarlo en ese recorrido.
+     * Si el disparo apunta fuera del mapa o el caché está lleno, se traza como siempre.
+     */
+    int firstTankHit(int shooter, int fromRow, int fromCol, int toRow, int toCol, ProjectileType type) {
+        int offset = -1;
+        if (gameMap.isValidIndex(fromRow, fromCol) && gameMap.isValidIndex(toRow, toCol)) {
+            offset = cachedTrajectory(cell(fromRow, fromCol), cell(toRow, toCol), type);
+        }
+        if (offset < 0) {
+            return Ballistics::trace(gameMap, occupancy.data(), {fromRow, fromCol, toRow, toCol, Projectile::of(type), shooter}).tankId;
+        }
+        const int* path = trajectories.data() + offset;
+        for (int k = 1; k <= path[0]; ++k) {
+            int occupant = occupancy[path[k]];
+            if (occupant >= 0 && occupant != shooter) return occupant;
+        }
+        return -1;
+    }
+
+    // Posición en `trajectories` del recorrido [largo, celdas...] de un disparo, o -1 si no cabe
+    int cachedTrajectory(int from, int to, ProjectileType type) {
+        std::uint64_t key = ((static_cast<std::uint64_t>(from) * static_cast<std::uint64_t>(rows * cols) + static_cast<std::uint64_t>(to)) << 2)
+                            + static_cast<std::uint64_t>(type) + 1; // 0 = lugar vacío
+        if (trajectoryKeys.empty()) {
+            trajectoryKeys.assign(1024, 0);
+            trajectoryStart.assign(1024, -1);
+        }
+        std::size_t mask = trajectoryKeys.size() - 1;
+        std::size_t slot = static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ULL) >> 20) & mask;
+        while (trajectoryKeys[slot] != 0) {
+            if (trajectoryKeys[slot] == key) return trajectoryStart[slot];
+            slot = (slot + 1) & mask;
+        }
+        if (trajectories.size() >= MAX_TRAJECTORY_CACHE) return -1;
+
+        std::vector<QPoint>& path = tracedPath;
+        Ballistics::trace(gameMap, nullptr, {from / cols, from % cols, to / cols, to % cols, Projectile::of(type), -1}, &path);
+        int offset = static_cast<int>(trajectories.size());
+        trajectories.push_back(static_cast<int>(path.size()) - 1);
+        for (std::size_t k = 1; k < path.size(); ++k) {
+            trajectories.push_back(cell(path[k].x(), path[k].y()));
+        }
+        trajectoryKeys[slot] = key;
+        trajectoryStart[slot] = offset;
+        if (++trajectoryCount * 2 > trajectoryKeys.size()) growTrajectoryTable();
+        return offset;
+    }
+
+    void growTrajectoryTable() {
+        std::vector<std::uint64_t> oldKeys(trajectoryKeys.size() * 2, 0);
+        std::vector<int> oldStart(trajectoryStart.size() * 2, -1);
+        oldKeys.swap(trajectoryKeys);
+        oldStart.swap(trajectoryStart);
+        std::size_t mask = trajectoryKeys.size() - 1;
+        for (std::size_t k = 0; k < oldKeys.size(); ++k) {
+            if (oldKeys[k] == 0) continue;
+            std::size_t slot = static_cast<std::size_t>((oldKeys[k] * 0x9E3779B97F4A7C15ULL) >> 20) & mask;
+            while (trajectoryKeys[slot] != 0) slot = (slot + 1) & mask;
+            trajectoryKeys[slot] = oldKeys[k];
+            trajectoryStart[slot] = oldStart[k];
+        }
+    }
+
+    /*
+     * Rebotes desde (row, col), calculados la primera vez: se traza cada rayo sin tanques y se
+     * guarda un índice por celda con los (rayo, paso) que pasan por ella, solo la primera vez que
+     * la pisa cada rayo. Un proyectil se detiene en el primer tanque que pisa, así que el tanque
+     * alcanzado por un rayo es el de menor paso entre las celdas ocupadas. La celda de salida no
+     * entra (un proyectil no se impacta a quien lo dispara).
+     * El bloque empieza con numCells + 1 posiciones (relativas al bloque) y siguen los pares.
+     * Devuelve -1 si ya no cabe en el caché; entonces se trazan los rayos como cualquier disparo.
+     */
+    int cachedBounces(int row, int col) {
+        int from = cell(row, col);
+        if (bounceOffset[from] >= 0) return bounceOffset[from];
+        const int numCells = rows * cols;
+        if (bounceIndex.size() + static_cast<std::size_t>(numCells) + 1 > MAX_BOUNCE_CACHE) return -1;
+
+        Projectile bouncing = Projectile::of(ProjectileType::Bouncing);
+        std::vector<QPoint> path;
+        std::vector<int> entries; // (celda, rayo, paso) de la primera visita de cada rayo a cada celda
+        for (std::size_t ray = 0; ray < borderTargets.size(); ++ray) {
+            Ballistics::trace(gameMap, nullptr, {row, col, borderTargets[ray].x(), borderTargets[ray].y(), bouncing, -1}, &path);
+            if (++stamp == 0) {
+                std::fill(visitStamp.begin(), visitStamp.end(), 0);
+                stamp = 1;
+            }
+            visitStamp[from] = stamp;
+            for (std::size_t step = 1; step < path.size(); ++step) {
+                int at = cell(path[step].x(), path[step].y());
+                if (visitStamp[at] == stamp) continue;
+                visitStamp[at] = stamp;
+                entries.insert(entries.end(), {at, static_cast<int>(ray), static_cast<int>(step)});
+            }
+        }
+        std::size_t needed = static_cast<std::size_t>(numCells) + 1 + entries.size() / 3 * 2;
+        if (bounceIndex.size() + needed > MAX_BOUNCE_CACHE) return -1;
+
+        // Orden por celda con conteo: primero cuántas entradas tiene cada una, después se reparten
+        int offset = static_cast<int>(bounceIndex.size());
+        bounceIndex.resize(bounceIndex.size() + needed, 0);
+        int* index = bounceIndex.data() + offset;
+        for (std::size_t e = 0; e < entries.size(); e += 3) index[entries[e] + 1] += 2;
+        index[0] = numCells + 1;
+        for (int at = 0; at < numCells; ++at) index[at + 1] += index[at];
+        std::vector<int> fill(index, index + numCells);
+        for (std::size_t e = 0; e < entries.size(); e += 3) {
+            int& position = fill[entries[e]];
+            index[position] = entries[e + 1];
+            index[position + 1] = entries[e + 2];
+            position += 2;
+        }
+        if (rayStep.size() < borderTargets.size()) {
+            rayStep.assign(borderTargets.size(), INT_MAX);
+            rayTank.assign(borderTargets.size(), -1);
+        }
+        bounceOffset[from] = offset;
+        return offset;
+    }
+
+    // BFS acotado a moveRadius pasos desde el tanque; cada celda libre alcanzada es un destino
+    void generateMoves(const GameState& state, int i, std::vector<AiMove>& out) {
+        const GameState::TankSlot& tank = state.tanks[i];
+        if (++stamp == 0) {
+            std::fill(visitStamp.begin(), visitStamp.end(), 0);
+            stamp = 1;
+        }
+        frontier.clear();
+        int start = cell(tank.row, tank.col);
+        visitStamp[start] = stamp;
+        frontier.push_back(start);
+        std::size_t levelStart = 0;
+        for (int depth = 1; depth <= moveRadius && levelStart < frontier.size(); ++depth) {
+            std::size_t levelEnd = frontier.size();
+            for (std::size_t k = levelStart; k < levelEnd; ++k) {
+                int r = frontier[k] / cols;
+                int c = frontier[k] % cols;
+                static const int STEPS[4][2] = {{0, 1}, {1, 0}, {0, -1}, {-1, 0}};
+                for (const auto& step : STEPS) {
+                    int nr = r + step[0];
+                    int nc = c + step[1];
+                    if (nr < 0 || nr >= rows || nc < 0 || nc >= cols) continue;
+                    int next = cell(nr, nc);
+                    if (visitStamp[next] == stamp || gameMap.cellAt(nr, nc) == Map::OBSTACLE) continue;
+                    visitStamp[next] = stamp;
+                    frontier.push_back(next);
+                    if (occupancy[next] < 0) {
+                        out.push_back({AiMoveKind::Move, static_cast<std::uint8_t>(i), static_cast<std::int16_t>(nr),
+                                       static_cast<std::int16_t>(nc), ProjectileType::Standard});
+                    }
+                }
+            }
+            levelStart = levelEnd;
+        }
+    }
+};
+
+#endif // GAMESTATE_H
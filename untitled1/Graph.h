@@ -2,32 +2,73 @@
 #define MAP_H
 
 #include <iostream>
-#include <QRandomGenerator>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <QPoint>
+#include "Rng.h"
 
 class Map {
 private:
-    static const int rows = 15;
-    static const int cols = 18;
-    int adjMatrix[rows][cols];  // Matriz de adyacencia
+    int rows;
+    int cols;
+    // Matriz de adyacencia guardada de forma plana (fila por fila), un byte por celda
+    std::vector<std::int8_t> adjMatrix;
+    std::uint64_t version = 0;         // Cambia con cualquier modificación de celdas
+    std::uint64_t obstacleVersion = 0; // Cambia solo cuando se ponen o se quitan obstáculos
+
+    // Registro de las últimas celdas modificadas: changeLog[k] llevó la versión de changeLogBase + k a + k + 1
+    struct CellChange { int row; int col; };
+    std::vector<CellChange> changeLog;
+    std::uint64_t changeLogBase = 0;
+    static const std::size_t MAX_CHANGE_LOG = 4096;
+
+    int index(int i, int j) const { return i * cols + j; }
+
+    // Cambiar una celda dejando constancia en el registro
+    void setCell(int i, int j, int state) {
+        std::int8_t& cell = adjMatrix[index(i, j)];
+        if (cell == state) return;
+        if (cell == OBSTACLE || state == OBSTACLE) {
+            ++obstacleVersion;
+        }
+        cell = static_cast<std::int8_t>(state);
+        if (changeLog.size() >= MAX_CHANGE_LOG) {
+            changeLog.clear();
+            changeLogBase = version;
+        }
+        changeLog.push_back({i, j});
+        ++version;
+    }
+
+    // Cambio de muchas celdas a la vez: quien dependa del mapa tiene que recalcular todo
+    void markBulkChange() {
+        ++version;
+        ++obstacleVersion;
+        changeLog.clear();
+        changeLogBase = version;
+    }
 
 public:
     static const int OBSTACLE = -1;
     static const int FREE_SPACE = 0;
     static const int PATH = 1;
 
+    // Tamaño del mapa del juego original
+    static const int DEFAULT_ROWS = 15;
+    static const int DEFAULT_COLS = 18;
+
     // Constructor para inicializar la matriz con espacios libres
-    Map() {
-        resetMatrix();
+    explicit Map(int numRows = DEFAULT_ROWS, int numCols = DEFAULT_COLS)
+        : rows(std::max(numRows, 2)), cols(std::max(numCols, 1)),
+          adjMatrix(static_cast<std::size_t>(rows) * cols, FREE_SPACE) {
         setObstaclesOnLastTwoRows();
     }
 
     // Reiniciar la matriz
     void resetMatrix() {
-        for (int i = 0; i < rows; ++i) {
-            for (int j = 0; j < cols; ++j) {
-                adjMatrix[i][j] = FREE_SPACE;
-            }
-        }
+        std::fill(adjMatrix.begin(), adjMatrix.end(), static_cast<std::int8_t>(FREE_SPACE));
+        markBulkChange();
     }
 
     // Comprobar si el índice es válido
@@ -37,26 +78,54 @@ public:
 
     // Comprobar si una celda está ocupada
     bool isOccupied(int i, int j) const {
-        return isValidIndex(i, j) && (adjMatrix[i][j] != FREE_SPACE);
+        return isValidIndex(i, j) && (adjMatrix[index(i, j)] != FREE_SPACE);
     }
 
     // Añadir una arista o conexión
     void addEdge(int i, int j) {
-        if (isValidIndex(i, j) && adjMatrix[i][j] == FREE_SPACE) {
-            adjMatrix[i][j] = PATH;
+        if (isValidIndex(i, j) && adjMatrix[index(i, j)] == FREE_SPACE) {
+            setCell(i, j, PATH);
         }
     }
     void setObstaclesOnLastTwoRows() {
         for (int j = 0; j < cols; ++j) {
-            adjMatrix[rows - 1][j] = OBSTACLE;       // Última fila
-            adjMatrix[rows - 2][j] = OBSTACLE;       // Penúltima fila
+            adjMatrix[index(rows - 1, j)] = OBSTACLE;       // Última fila
+            adjMatrix[index(rows - 2, j)] = OBSTACLE;       // Penúltima fila
+        }
+        markBulkChange();
+    }
+
+    /*
+     * Cargar todos los obstáculos de una vez (un byte por celda, fila por fila, distinto de cero = obstáculo).
+     * Las demás celdas quedan libres, así que se usa antes de colocar los tanques.
+     */
+    bool assignObstacles(const std::vector<std::uint8_t>& blocked) {
+        if (blocked.size() != adjMatrix.size()) return false;
+        for (std::size_t k = 0; k < blocked.size(); ++k) {
+            adjMatrix[k] = blocked[k] ? static_cast<std::int8_t>(OBSTACLE) : static_cast<std::int8_t>(FREE_SPACE);
         }
+        markBulkChange();
+        return true;
     }
 
     // Eliminar una arista o conexión
     void removeEdge(int i, int j) {
-        if (isValidIndex(i, j) && adjMatrix[i][j] != OBSTACLE) {
-            adjMatrix[i][j] = FREE_SPACE;
+        if (isValidIndex(i, j) && adjMatrix[index(i, j)] == PATH) {
+            setCell(i, j, FREE_SPACE);
+        }
+    }
+
+    // Poner un obstáculo en una celda libre (no se ponen encima de un tanque)
+    void setObstacle(int i, int j) {
+        if (isValidIndex(i, j) && adjMatrix[index(i, j)] == FREE_SPACE) {
+            setCell(i, j, OBSTACLE);
+        }
+    }
+
+    // Quitar un obstáculo y dejar la celda libre
+    void clearObstacle(int i, int j) {
+        if (isValidIndex(i, j) && adjMatrix[index(i, j)] == OBSTACLE) {
+            setCell(i, j, FREE_SPACE);
         }
     }
 
@@ -71,7 +140,7 @@ public:
         for (int i = 0; i < rows; ++i) {
             std::cout << i << " ";
             for (int j = 0; j < cols; ++j) {
-                std::cout << adjMatrix[i][j] << " ";
+                std::cout << static_cast<int>(adjMatrix[index(i, j)]) << " ";
             }
             std::cout << std::endl;
         }
@@ -79,22 +148,27 @@ public:
 
     // Comprobar si una celda está conectada
     bool isConnected(int i, int j) const {
-        return isValidIndex(i, j) && adjMatrix[i][j] == PATH;
+        return isValidIndex(i, j) && adjMatrix[index(i, j)] == PATH;
     }
 
     // Generar obstáculos de manera aleatoria en el mapa
     void generateObstacles() {
+        generateObstacles(Rng::threadLocal());
+    }
+
+    // Con un generador propio los obstáculos se repiten igual para la misma semilla
+    void generateObstacles(Rng& rng) {
         int obstaclesAdded = 0;
         const int maxObstacles = 5; // Número máximo de obstáculos
 
         while (obstaclesAdded < maxObstacles) {
             // Generar posición inicial aleatoria
-            int row = QRandomGenerator::global()->bounded(0, rows);
-            int col = QRandomGenerator::global()->bounded(0, cols);
+            int row = rng.bounded(0, rows);
+            int col = rng.bounded(0, cols);
 
             // Decidir orientación y tamaño del obstáculo
-            bool horizontal = QRandomGenerator::global()->bounded(0, 2) == 0;
-            int obstacleSize = QRandomGenerator::global()->bounded(2, 4); // Tamaño del obstáculo entre 2 y 3 celdas
+            bool horizontal = rng.bounded(0, 2) == 0;
+            int obstacleSize = rng.bounded(2, 4); // Tamaño del obstáculo entre 2 y 3 celdas
 
             if (horizontal && col + obstacleSize <= cols) {  // Obstáculo horizontal
                 bool canPlace = true;
@@ -106,7 +180,7 @@ public:
                 }
                 if (canPlace) {
                     for (int k = 0; k < obstacleSize; ++k) {
-                        adjMatrix[row][col + k] = OBSTACLE;
+                        setCell(row, col + k, OBSTACLE);
                     }
                     obstaclesAdded++;
                 }
@@ -120,7 +194,7 @@ public:
                 }
                 if (canPlace) {
                     for (int k = 0; k < obstacleSize; ++k) {
-                        adjMatrix[row + k][col] = OBSTACLE;
+                        setCell(row + k, col, OBSTACLE);
                     }
                     obstaclesAdded++;
                 }
@@ -130,12 +204,34 @@ public:
 
     // Comprobar si una celda es un obstáculo
     bool isObstacle(int i, int j) const {
-        return isValidIndex(i, j) && adjMatrix[i][j] == OBSTACLE;
+        return isValidIndex(i, j) && adjMatrix[index(i, j)] == OBSTACLE;
     }
 
     // Obtener el número de filas y columnas
     int getNumRows() const { return rows; }
     int getNumCols() const { return cols; }
+    int getNumCells() const { return rows * cols; }
+
+    // Versiones para saber si datos precalculados sobre el mapa siguen siendo válidos
+    std::uint64_t getVersion() const { return version; }
+    std::uint64_t getObstacleVersion() const { return obstacleVersion; }
+
+    /*
+     * Agregar a `out` las celdas modificadas desde `sinceVersion` (puede haber repetidas).
+     * Devuelve false si el registro ya no llega tan atrás; en ese caso hay que recalcular todo.
+     */
+    bool changesSince(std::uint64_t sinceVersion, std::vector<QPoint>& out) const {
+        if (sinceVersion < changeLogBase || sinceVersion > version) {
+            return false;
+        }
+        for (std::size_t k = static_cast<std::size_t>(sinceVersion - changeLogBase); k < changeLog.size(); ++k) {
+            out.push_back({changeLog[k].row, changeLog[k].col});
+        }
+        return true;
+    }
+
+    // Estado crudo de una celda (OBSTACLE, FREE_SPACE o PATH), sin validar el índice
+    int cellAt(int i, int j) const { return adjMatrix[index(i, j)]; }
 };
 
 #endif // MAP_H
@@ -0,0 +1,423 @@
+#ifndef HIERARCHICALPATHFINDING_H
+#define HIERARCHICALPATHFINDING_H
+
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <QPoint>
+#include "Graph.h"
+#include "PathfindingWorkspace.h"
+
+/*
+ * Pathfinding jerárquico (HPA*) para mapas grandes.
+ *
+ * El mapa se divide en clusters cuadrados. En cada borde entre dos clusters vecinos se buscan
+ * los tramos donde ambos lados son transitables y se pone una transición (dos si el tramo es
+ * largo). Las celdas de las transiciones son los nodos del grafo abstracto: entre nodos del
+ * mismo cluster hay una arista con la distancia real dentro del cluster y entre los dos lados
+ * de una transición una arista de costo 1.
+ *
+ * Una consulta conecta inicio y destino a los nodos de su cluster, busca con A* en el grafo
+ * abstracto y solo refina (con BFS acotado al cluster) los tramos del camino elegido. El
+ * resultado está muy cerca del óptimo pero no siempre es el más corto.
+ *
+ * Al igual que bfsPath, solo los obstáculos bloquean; los cambios de ocupación (addEdge /
+ * removeEdge) se revisan en el registro del mapa pero no invalidan nada. Un obstáculo nuevo
+ * o quitado solo reconstruye su cluster y los datos de sus vecinos que dependen de él.
+ */
+class HierarchicalPathfinder {
+public:
+    static const int DEFAULT_CLUSTER_SIZE = 16;
+
+    explicit HierarchicalPathfinder(int clusterSize = DEFAULT_CLUSTER_SIZE)
+        : clusterSize(std::max(clusterSize, 4)) {}
+
+    // Construir todo desde cero
+    void build(const Map& gameMap) {
+        rows = gameMap.getNumRows();
+        cols = gameMap.getNumCols();
+        clusterRows = (rows + clusterSize - 1) / clusterSize;
+        clusterCols = (cols + clusterSize - 1) / clusterSize;
+        int numClusters = clusterRows * clusterCols;
+
+        blocked.assign(static_cast<std::size_t>(rows) * cols, false);
+        for (int i = 0; i < rows; ++i) {
+            for (int j = 0; j < cols; ++j) {
+                blocked[cell(i, j)] = gameMap.isObstacle(i, j);
+            }
+        }
+
+        clusters.assign(numClusters, Cluster());
+        eastTransitions.assign(numClusters, {});
+        southTransitions.assign(numClusters, {});
+        for (int c = 0; c < numClusters; ++c) {
+            computeTransitions(c);
+        }
+        for (int c = 0; c < numClusters; ++c) {
+            rebuildCluster(c);
+        }
+        builtVersion = gameMap.getVersion();
+        built = true;
+    }
+
+    /*
+     * Poner al día los datos con los cambios del mapa. Solo se reconstruyen los clusters
+     * donde cambió algún obstáculo; si el registro del mapa ya no alcanza, se reconstruye todo.
+     */
+    void refresh(const Map& gameMap) {
+        if (!built || gameMap.getNumRows() != rows || gameMap.getNumCols() != cols) {
+            build(gameMap);
+            return;
+        }
+        if (gameMap.getVersion() == builtVersion) return;
+
+        std::vector<QPoint> changed;
+        if (!gameMap.changesSince(builtVersion, changed)) {
+            build(gameMap);
+            return;
+        }
+
+        std::vector<int> dirty;
+        for (const QPoint& at : changed) {
+            bool isBlocked = gameMap.isObstacle(at.x(), at.y());
+            if (blocked[cell(at.x(), at.y())] == isBlocked) continue; // Solo cambió la ocupación
+            blocked[cell(at.x(), at.y())] = isBlocked;
+            dirty.push_back(clusterOf(at.x(), at.y()));
+        }
+        builtVersion = gameMap.getVersion();
+        if (dirty.empty()) return;
+
+        std::sort(dirty.begin(), dirty.end());
+        dirty.erase(std::unique(dirty.begin(), dirty.end()), dirty.end());
+
+        // Las transiciones de los cuatro bordes del cluster cambian; las guarda el cluster o su vecino
+        std::vector<int> affected;
+        for (int c : dirty) {
+            int cr = c / clusterCols;
+            int cc = c % clusterCols;
+            computeTransitions(c);
+            if (cc > 0) computeTransitions(c - 1);
+            if (cr > 0) computeTransitions(c - clusterCols);
+
+            affected.push_back(c);
+            if (cc > 0) affected.push_back(c - 1);
+            if (cc + 1 < clusterCols) affected.push_back(c + 1);
+            if (cr > 0) affected.push_back(c - clusterCols);
+            if (cr + 1 < clusterRows) affected.push_back(c + clusterCols);
+        }
+        std::sort(affected.begin(), affected.end());
+        affected.erase(std::unique(affected.begin(), affected.end()), affected.end());
+        for (int c : affected) {
+            rebuildCluster(c);
+        }
+        rebuiltClusters += static_cast<long long>(affected.size());
+    }
+
+    // Camino de inicio a destino (mismas reglas de entrada que dijkstraPath)
+    std::vector<QPoint> findPath(const Map& gameMap, int startRow, int startCol, int targetRow, int targetCol) {
+        refresh(gameMap);
+        if (!gameMap.isValidIndex(startRow, startCol) || !gameMap.isValidIndex(targetRow, targetCol)) {
+            return {};
+        }
+        if (startRow == targetRow && startCol == targetCol) {
+            return {{startRow, startCol}};
+        }
+        if (blocked[cell(targetRow, targetCol)]) {
+            return {};
+        }
+        if (blocked[cell(startRow, startCol)]) {
+            return findPathFromBlockedStart(gameMap, startRow, startCol, targetRow, targetCol);
+        }
+
+        int start = cell(startRow, startCol);
+        int target = cell(targetRow, targetCol);
+        int startCluster = clusterOf(startRow, startCol);
+        int targetCluster = clusterOf(targetRow, targetCol);
+
+        // Aristas temporales del inicio hacia los nodos de su cluster (y al destino si está ahí mismo)
+        std::vector<Edge> startEdges;
+        localBfs(startCluster, start);
+        for (int node : clusters[startCluster].nodes) {
+            if (node != start && localWorkspace.isSeen(node)) {
+                startEdges.push_back({node, localWorkspace.cost(node)});
+            }
+        }
+        if (startCluster == targetCluster && localWorkspace.isSeen(target)) {
+            startEdges.push_back({target, localWorkspace.cost(target)});
+        }
+
+        // Costo de cada nodo del cluster destino hasta el destino (la cuadrícula es simétrica)
+        std::vector<Edge> targetEdges;
+        localBfs(targetCluster, target);
+        for (int node : clusters[targetCluster].nodes) {
+            if (localWorkspace.isSeen(node)) {
+                targetEdges.push_back({node, localWorkspace.cost(node)});
+            }
+        }
+
+        std::vector<int> abstractPath = abstractSearch(start, target, startEdges, targetEdges);
+        if (abstractPath.empty()) {
+            return {};
+        }
+        return refine(abstractPath);
+    }
+
+    int getClusterSize() const { return clusterSize; }
+    int getNumClusters() const { return clusterRows * clusterCols; }
+    int getAbstractNodeCount() const {
+        int total = 0;
+        for (const Cluster& cluster : clusters) total += static_cast<int>(cluster.nodes.size());
+        return total;
+    }
+    // Cuántos clusters se han reconstruido por cambios incrementales (para medir)
+    long long getRebuiltClusters() const { return rebuiltClusters; }
+    int getLastAbstractExpanded() const { return lastAbstractExpanded; }
+
+private:
+    struct Edge {
+        int to;   // Celda destino
+        int cost;
+    };
+
+    struct Transition {
+        int inside;  // Celda del lado de este cluster
+        int outside; // Celda del lado del vecino (este o sur)
+    };
+
+    struct Cluster {
+        std::vector<int> nodes;              // Celdas de transición dentro del cluster
+        std::vector<std::vector<Edge>> edges; // edges[i]: aristas que salen de nodes[i]
+    };
+
+    int clusterSize;
+    int rows = 0;
+    int cols = 0;
+    int clusterRows = 0;
+    int clusterCols = 0;
+    bool built = false;
+    std::uint64_t builtVersion = 0;
+    long long rebuiltClusters = 0;
+    int lastAbstractExpanded = 0;
+
+    std::vector<bool> blocked; // Copia de los obstáculos con la que se construyeron los datos
+    std::vector<Cluster> clusters;
+    std::vector<std::vector<Transition>> eastTransitions;  // Borde con el cluster de la derecha
+    std::vector<std::vector<Transition>> southTransitions; // Borde con el cluster de abajo
+
+    PathfindingWorkspace localWorkspace;
+    PathfindingWorkspace abstractWorkspace;
+
+    int cell(int row, int col) const { return row * cols + col; }
+    int clusterOf(int row, int col) const { return (row / clusterSize) * clusterCols + col / clusterSize; }
+    int clusterOfCell(int c) const { return clusterOf(c / cols, c % cols); }
+
+    int clusterTop(int c) const { return (c / clusterCols) * clusterSize; }
+    int clusterLeft(int c) const { return (c % clusterCols) * clusterSize; }
+    int clusterBottom(int c) const { return std::min(clusterTop(c) + clusterSize, rows); }
+    int clusterRight(int c) const { return std::min(clusterLeft(c) + clusterSize, cols); }
+
+    // Transiciones de los bordes este y sur del cluster c
+    void computeTransitions(int c) {
+        eastTransitions[c].clear();
+        southTransitions[c].clear();
+        int top = clusterTop(c), bottom = clusterBottom(c);
+        int left = clusterLeft(c), right = clusterRight(c);
+
+        if (right < cols) {
+            int col = right - 1;
+            addEntrances(eastTransitions[c], bottom - top, [&](int k) {
+                return Transition{cell(top + k, col), cell(top + k, col + 1)};
+            });
+        }
+        if (bottom < rows) {
+            int row = bottom - 1;
+            addEntrances(southTransitions[c], right - left, [&](int k) {
+                return Transition{cell(row, left + k), cell(row + 1, left + k)};
+            });
+        }
+    }
+
+    // Recorrer un borde de `length` celdas y poner transiciones en cada tramo libre a ambos lados
+    template <typename PairAt>
+    void addEntrances(std::vector<Transition>& out, int length, PairAt pairAt) {
+        int runStart = -1;
+        for (int k = 0; k <= length; ++k) {
+            bool open = false;
+            if (k < length) {
+                Transition t = pairAt(k);
+                open = !blocked[t.inside] && !blocked[t.outside];
+            }
+            if (open && runStart < 0) {
+                runStart = k;
+            } else if (!open && runStart >= 0) {
+                int runEnd = k - 1;
+                if (runEnd - runStart + 1 >= 6) {
+                    out.push_back(pairAt(runStart));
+                    out.push_back(pairAt(runEnd));
+                } else {
+                    out.push_back(pairAt((runStart + runEnd) / 2));
+                }
+                runStart = -1;
+            }
+        }
+    }
+
+    // Nodos del cluster, aristas entre ellos (distancia dentro del cluster) y aristas de transición
+    void rebuildCluster(int c) {
+        Cluster& cluster = clusters[c];
+
+        // inside = celda de este cluster, outside = celda del vecino
+        std::vector<Transition> links = eastTransitions[c];
+        links.insert(links.end(), southTransitions[c].begin(), southTransitions[c].end());
+        int cr = c / clusterCols;
+        int cc = c % clusterCols;
+        if (cc > 0) {
+            for (const Transition& t : eastTransitions[c - 1]) links.push_back({t.outside, t.inside});
+        }
+        if (cr > 0) {
+            for (const Transition& t : southTransitions[c - clusterCols]) links.push_back({t.outside, t.inside});
+        }
+
+        cluster.nodes.clear();
+        for (const Transition& link : links) cluster.nodes.push_back(link.inside);
+        std::sort(cluster.nodes.begin(), cluster.nodes.end());
+        cluster.nodes.erase(std::unique(cluster.nodes.begin(), cluster.nodes.end()), cluster.nodes.end());
+
+        cluster.edges.assign(cluster.nodes.size(), {});
+        for (std::size_t i = 0; i < cluster.nodes.size(); ++i) {
+            localBfs(c, cluster.nodes[i]);
+            for (std::size_t j = 0; j < cluster.nodes.size(); ++j) {
+                if (i != j && localWorkspace.isSeen(cluster.nodes[j])) {
+                    cluster.edges[i].push_back({cluster.nodes[j], localWorkspace.cost(cluster.nodes[j])});
+                }
+            }
+        }
+        for (const Transition& link : links) {
+            cluster.edges[nodeSlot(cluster, link.inside)].push_back({link.outside, 1});
+        }
+    }
+
+    static int nodeSlot(const Cluster& cluster, int node) {
+        auto it = std::lower_bound(cluster.nodes.begin(), cluster.nodes.end(), node);
+        return (it != cluster.nodes.end() && *it == node) ? static_cast<int>(it - cluster.nodes.begin()) : -1;
+    }
+
+    // BFS desde `source` sin salir del cluster c; deja costos y padres en localWorkspace
+    void localBfs(int c, int source) {
+        int top = clusterTop(c), bottom = clusterBottom(c);
+        int left = clusterLeft(c), right = clusterRight(c);
+        static constexpr int DIRECTIONS[4][2] = {{0, 1}, {1, 0}, {0, -1}, {-1, 0}};
+
+        localWorkspace.begin(rows * cols);
+        localWorkspace.reach(source, 0, -1);
+        localWorkspace.pushFifo(source);
+        while (!localWorkspace.fifoEmpty()) {
+            int current = localWorkspace.popFifo();
+            int row = current / cols;
+            int col = current % cols;
+            for (const auto& dir : DIRECTIONS) {
+                int newRow = row + dir[0];
+                int newCol = col + dir[1];
+                if (newRow < top || newRow >= bottom || newCol < left || newCol >= right) continue;
+                int next = cell(newRow, newCol);
+                if (!blocked[next] && !localWorkspace.isSeen(next)) {
+                    localWorkspace.reach(next, localWorkspace.cost(current) + 1, current);
+                    localWorkspace.pushFifo(next);
+                }
+            }
+        }
+    }
+
+    /*
+     * dijkstraPath permite salir de un inicio que es obstáculo. Desde ahí no se llega a ningún nodo del
+     * cluster si el primer paso ya cruza el borde, así que se prueba desde cada vecino libre.
+     */
+    std::vector<QPoint> findPathFromBlockedStart(const Map& gameMap, int startRow, int startCol, int targetRow, int targetCol) {
+        static constexpr int DIRECTIONS[4][2] = {{0, 1}, {1, 0}, {0, -1}, {-1, 0}};
+        std::vector<QPoint> best;
+        for (const auto& dir : DIRECTIONS) {
+            int row = startRow + dir[0];
+            int col = startCol + dir[1];
+            if (!gameMap.isValidIndex(row, col) || blocked[cell(row, col)]) continue;
+            std::vector<QPoint> path = findPath(gameMap, row, col, targetRow, targetCol);
+            if (!path.empty() && (best.empty() || path.size() < best.size())) {
+                best = std::move(path);
+            }
+        }
+        if (!best.empty()) {
+            best.insert(best.begin(), QPoint(startRow, startCol));
+        }
+        return best;
+    }
+
+    // A* sobre el grafo abstracto; devuelve la secuencia de celdas (inicio, nodos..., destino)
+    std::vector<int> abstractSearch(int start, int target, const std::vector<Edge>& startEdges,
+                                    const std::vector<Edge>& targetEdges) {
+        auto heuristic = [&](int c) {
+            return std::abs(c / cols - target / cols) + std::abs(c % cols - target % cols);
+        };
+        int targetCluster = clusterOfCell(target);
+
+        abstractWorkspace.begin(rows * cols);
+        abstractWorkspace.reach(start, 0, -1);
+        abstractWorkspace.pushHeap({start, 0, heuristic(start)});
+        lastAbstractExpanded = 0;
+
+        auto relax = [&](int from, int fromCost, int to, int edgeCost) {
+            int newCost = fromCost + edgeCost;
+            if (newCost < abstractWorkspace.cost(to)) {
+                abstractWorkspace.reach(to, newCost, from);
+                abstractWorkspace.pushHeap({to, newCost, newCost + heuristic(to)});
+            }
+        };
+
+        while (!abstractWorkspace.heapEmpty()) {
+            PathfindingWorkspace::HeapNode current = abstractWorkspace.popHeap();
+            if (current.cost > abstractWorkspace.cost(current.node)) continue;
+            ++lastAbstractExpanded;
+
+            if (current.node == target) {
+                std::vector<int> path;
+                for (int at = target; at != -1; at = abstractWorkspace.parent(at)) path.push_back(at);
+                std::reverse(path.begin(), path.end());
+                return path;
+            }
+
+            const Cluster& cluster = clusters[clusterOfCell(current.node)];
+            int slot = nodeSlot(cluster, current.node);
+            if (current.node == start) {
+                for (const Edge& e : startEdges) relax(current.node, current.cost, e.to, e.cost);
+            }
+            if (slot >= 0) {
+                for (const Edge& e : cluster.edges[slot]) relax(current.node, current.cost, e.to, e.cost);
+                if (clusterOfCell(current.node) == targetCluster) {
+                    for (const Edge& e : targetEdges) {
+                        if (e.to == current.node) relax(current.node, current.cost, target, e.cost);
+                    }
+                }
+            }
+        }
+        return {};
+    }
+
+    // Convertir el camino abstracto en celdas, buscando solo dentro del cluster de cada tramo
+    std::vector<QPoint> refine(const std::vector<int>& abstractPath) {
+        std::vector<QPoint> path;
+        path.push_back({abstractPath.front() / cols, abstractPath.front() % cols});
+        for (std::size_t i = 1; i < abstractPath.size(); ++i) {
+            int from = abstractPath[i - 1];
+            int to = abstractPath[i];
+            if (clusterOfCell(from) != clusterOfCell(to)) {
+                path.push_back({to / cols, to % cols}); // Transición entre clusters: celdas vecinas
+                continue;
+            }
+            localBfs(clusterOfCell(from), from);
+            std::vector<QPoint> segment = localWorkspace.buildCellPath(to, cols);
+            path.insert(path.end(), segment.begin() + 1, segment.end());
+        }
+        return path;
+    }
+};
+
+#endif // HIERARCHICALPATHFINDING_H
@@ -0,0 +1,300 @@
+#ifndef INCREMENTALPATHFINDING_H
+#define INCREMENTALPATHFINDING_H
+
+#include <vector>
+#include <queue>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <unordered_map>
+#include <QPoint>
+#include "Graph.h"
+
+/*
+ * D* Lite: planificador incremental para un tanque que se mueve hacia un destino fijo.
+ *
+ * La búsqueda va del destino hacia el tanque y se guarda entre turnos. Cuando cambian celdas
+ * del mapa (otros tanques que se mueven con addEdge/removeEdge, obstáculos nuevos) solo se
+ * reparan los nodos afectados en vez de buscar todo de nuevo, y cuando el tanque avanza solo
+ * se ajusta el término km de las prioridades.
+ *
+ * A diferencia de bfsPath, aquí las celdas ocupadas por otros tanques también bloquean:
+ * justamente son los cambios que invalidan los caminos. La celda del propio tanque y el
+ * destino siempre se consideran transitables.
+ */
+class DStarLite {
+public:
+    static constexpr int INFINITE_COST = 1 << 29;
+
+    // Empezar un plan nuevo hacia (goalRow, goalCol)
+    void reset(const Map& gameMap, int startRow, int startCol, int goalRow, int goalCol) {
+        rows = gameMap.getNumRows();
+        cols = gameMap.getNumCols();
+        start = cell(startRow, startCol);
+        lastStart = start;
+        goal = cell(goalRow, goalCol);
+        km = 0;
+
+        std::size_t numCells = static_cast<std::size_t>(rows) * cols;
+        g.assign(numCells, INFINITE_COST);
+        rhs.assign(numCells, INFINITE_COST);
+        openKey.assign(numCells, Key{-1, -1});
+        blocked.assign(numCells, 0);
+        open = {};
+        for (int i = 0; i < rows; ++i) {
+            for (int j = 0; j < cols; ++j) {
+                blocked[cell(i, j)] = computeBlocked(gameMap, cell(i, j)) ? 1 : 0;
+            }
+        }
+        syncedVersion = gameMap.getVersion();
+
+        rhs[goal] = 0;
+        insert(goal, calculateKey(goal));
+        initialized = true;
+    }
+
+    bool isInitialized() const { return initialized; }
+    bool hasGoal(int row, int col) const { return initialized && goal == cell(row, col); }
+    bool matchesMap(const Map& gameMap) const {
+        return gameMap.getNumRows() == rows && gameMap.getNumCols() == cols;
+    }
+
+    // El tanque avanzó: solo cambia el término km y se revisan las celdas vieja y nueva
+    void updateStart(const Map& gameMap, int startRow, int startCol) {
+        int newStart = cell(startRow, startCol);
+        if (newStart == start) return;
+        int oldStart = start;
+        start = newStart;
+        km += heuristic(lastStart, start);
+        lastStart = start;
+        cellChanged(gameMap, oldStart);
+        cellChanged(gameMap, newStart);
+    }
+
+    /*
+     * Leer del registro del mapa las celdas que cambiaron desde la última vez y reparar la búsqueda.
+     * Si el registro ya no alcanza, se rehace el plan desde cero con el mismo destino.
+     */
+    void syncWithMap(const Map& gameMap) {
+        if (gameMap.getVersion() == syncedVersion) return;
+        std::vector<QPoint> changed;
+        if (!gameMap.changesSince(syncedVersion, changed)) {
+            reset(gameMap, start / cols, start % cols, goal / cols, goal % cols);
+            return;
+        }
+        for (const QPoint& at : changed) {
+            cellChanged(gameMap, cell(at.x(), at.y()));
+        }
+        syncedVersion = gameMap.getVersion();
+    }
+
+    // Camino actual de la celda del tanque al destino (vacío si no hay)
+    std::vector<QPoint> currentPath() {
+        computeShortestPath();
+        // La búsqueda puede terminar con el inicio sobreconsistente: su rhs ya es el costo correcto
+        if (rhs[start] >= INFINITE_COST) {
+            return {};
+        }
+
+        std::vector<QPoint> path;
+        int at = start;
+        path.push_back({at / cols, at % cols});
+        for (int steps = 0; at != goal && steps < rows * cols; ++steps) {
+            int best = -1;
+            int bestCost = INFINITE_COST;
+            forEachNeighbor(at, [&](int next) {
+                int through = addCost(edgeCost(at, next), g[next]);
+                if (through < bestCost) {
+                    bestCost = through;
+                    best = next;
+                }
+            });
+            if (best < 0) return {};
+            at = best;
+            path.push_back({at / cols, at % cols});
+        }
+        return at == goal ? path : std::vector<QPoint>();
+    }
+
+    // Nodos expandidos en total (para comparar con una búsqueda desde cero)
+    long long getExpanded() const { return expanded; }
+
+private:
+    struct Key {
+        long long first;
+        long long second;
+        bool operator<(const Key& other) const {
+            return first != other.first ? first < other.first : second < other.second;
+        }
+        bool operator==(const Key& other) const { return first == other.first && second == other.second; }
+    };
+
+    struct OpenEntry {
+        Key key;
+        int node;
+        bool operator<(const OpenEntry& other) const { return other.key < key; } // Menor clave primero
+    };
+
+    int rows = 0;
+    int cols = 0;
+    int start = 0;
+    int lastStart = 0;
+    int goal = 0;
+    long long km = 0;
+    bool initialized = false;
+    std::uint64_t syncedVersion = 0;
+    long long expanded = 0;
+
+    std::vector<int> g;
+    std::vector<int> rhs;
+    std::vector<Key> openKey;          // Clave vigente de cada nodo en la cola; first == -1 si no está
+    std::vector<std::uint8_t> blocked; // Estado con el que se calcularon g y rhs
+    std::priority_queue<OpenEntry> open;
+
+    int cell(int row, int col) const { return row * cols + col; }
+
+    int heuristic(int a, int b) const {
+        return std::abs(a / cols - b / cols) + std::abs(a % cols - b % cols);
+    }
+
+    static int addCost(int a, int b) {
+        return (a >= INFINITE_COST || b >= INFINITE_COST) ? INFINITE_COST : a + b;
+    }
+
+    bool computeBlocked(const Map& gameMap, int c) const {
+        if (c == start || c == goal) return false;
+        int row = c / cols;
+        int col = c % cols;
+        return gameMap.isObstacle(row, col) || gameMap.isConnected(row, col);
+    }
+
+    int edgeCost(int a, int b) const {
+        return (blocked[a] || blocked[b]) ? INFINITE_COST : 1;
+    }
+
+    template <typename Fn>
+    void forEachNeighbor(int c, Fn fn) const {
+        int row = c / cols;
+        int col = c % cols;
+        if (col + 1 < cols) fn(c + 1);
+        if (row + 1 < rows) fn(c + cols);
+        if (col > 0) fn(c - 1);
+        if (row > 0) fn(c - cols);
+    }
+
+    Key calculateKey(int node) const {
+        long long best = std::min(g[node], rhs[node]);
+        return {best + heuristic(start, node) + km, best};
+    }
+
+    void insert(int node, const Key& key) {
+        openKey[node] = key;
+        open.push({key, node});
+    }
+
+    bool isOpen(int node) const { return openKey[node].first >= 0; }
+    void removeFromOpen(int node) { openKey[node] = Key{-1, -1}; }
+
+    // Descartar entradas viejas del tope de la cola (se borran de forma perezosa)
+    void skipStale() {
+        while (!open.empty()) {
+            const OpenEntry& top = open.top();
+            if (isOpen(top.node) && openKey[top.node] == top.key) return;
+            open.pop();
+        }
+    }
+
+    int bestSuccessorCost(int node) const {
+        int best = INFINITE_COST;
+        forEachNeighbor(node, [&](int next) {
+            best = std::min(best, addCost(edgeCost(node, next), g[next]));
+        });
+        return best;
+    }
+
+    void updateVertex(int node) {
+        if (node != goal) {
+            rhs[node] = bestSuccessorCost(node);
+        }
+        if (g[node] != rhs[node]) {
+            insert(node, calculateKey(node));
+        } else if (isOpen(node)) {
+            removeFromOpen(node);
+        }
+    }
+
+    // Una celda cambió: se recalculan ella y sus vecinos, porque cambian todas sus aristas
+    void cellChanged(const Map& gameMap, int c) {
+        std::uint8_t nowBlocked = computeBlocked(gameMap, c) ? 1 : 0;
+        if (nowBlocked == blocked[c]) return;
+        blocked[c] = nowBlocked;
+        updateVertex(c);
+        forEachNeighbor(c, [&](int next) { updateVertex(next); });
+    }
+
+    void computeShortestPath() {
+        skipStale();
+        while (!open.empty() && (open.top().key < calculateKey(start) || rhs[start] > g[start])) {
+            OpenEntry top = open.top();
+            int node = top.node;
+            Key newKey = calculateKey(node);
+            ++expanded;
+
+            if (top.key < newKey) {
+                insert(node, newKey);
+            } else if (g[node] > rhs[node]) {
+                g[node] = rhs[node];
+                removeFromOpen(node);
+                forEachNeighbor(node, [&](int pred) {
+                    if (pred != goal) {
+                        rhs[pred] = std::min(rhs[pred], addCost(edgeCost(pred, node), g[node]));
+                    }
+                    updateVertex(pred);
+                });
+            } else {
+                g[node] = INFINITE_COST;
+                updateVertex(node);
+                forEachNeighbor(node, [&](int pred) { updateVertex(pred); });
+            }
+            skipStale();
+        }
+    }
+};
+
+/*
+ * Planes incrementales por tanque. Cada tanque (identificado por un entero) conserva su D* Lite
+ * mientras siga yendo al mismo destino; al cambiar de destino se empieza un plan nuevo.
+ */
+class IncrementalPlanner {
+public:
+    std::vector<QPoint> plan(const Map& gameMap, int tankId, int startRow, int startCol, int targetRow, int targetCol) {
+        if (!gameMap.isValidIndex(startRow, startCol) || !gameMap.isValidIndex(targetRow, targetCol)) {
+            return {};
+        }
+        if (gameMap.isObstacle(targetRow, targetCol)) {
+            return {};
+        }
+
+        DStarLite& planner = plans[tankId];
+        if (!planner.isInitialized() || !planner.hasGoal(targetRow, targetCol) || !planner.matchesMap(gameMap)) {
+            planner.reset(gameMap, startRow, startCol, targetRow, targetCol);
+        } else {
+            planner.updateStart(gameMap, startRow, startCol);
+            planner.syncWithMap(gameMap);
+        }
+        return planner.currentPath();
+    }
+
+    void forget(int tankId) { plans.erase(tankId); }
+    void clear() { plans.clear(); }
+
+    long long getExpanded(int tankId) const {
+        auto it = plans.find(tankId);
+        return it == plans.end() ? 0 : it->second.getExpanded();
+    }
+
+private:
+    std::unordered_map<int, DStarLite> plans;
+};
+
+#endif // INCREMENTALPATHFINDING_H
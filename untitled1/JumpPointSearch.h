@@ -0,0 +1,292 @@
+#ifndef JUMPPOINTSEARCH_H
+#define JUMPPOINTSEARCH_H
+
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <QPoint>
+#include "Graph.h"
+#include "PathfindingWorkspace.h"
+
+/*
+ * Jump Point Search para la cuadrícula de 4 direcciones con costo uniforme.
+ *
+ * Caminos canónicos: un tramo vertical puede girar a horizontal en cualquier celda, pero un
+ * tramo horizontal solo gira a vertical en una celda "forzada" (la celda de atrás tiene ese
+ * vecino vertical bloqueado y esta no). Cualquier camino mínimo se puede reordenar así sin
+ * cambiar su largo, de modo que buscar solo entre puntos de salto da el mismo largo que
+ * dijkstraPath expandiendo muchos menos nodos.
+ *
+ * JumpPointTable es la variante JPS+: guarda por celda y dirección la distancia al siguiente
+ * punto de salto (o a la pared) y se reconstruye cuando cambian los obstáculos del mapa.
+ */
+class JumpPointSearch {
+public:
+    // Direcciones: 0 = derecha, 1 = abajo, 2 = izquierda, 3 = arriba
+    static constexpr int DIR_ROW[4] = {0, 1, 0, -1};
+    static constexpr int DIR_COL[4] = {1, 0, -1, 0};
+    static constexpr int NO_DIRECTION = 4; // Nodo inicial
+
+    static bool isHorizontal(int dir) { return dir == 0 || dir == 2; }
+
+    static bool passable(const Map& gameMap, int row, int col) {
+        return gameMap.isValidIndex(row, col) && !gameMap.isObstacle(row, col);
+    }
+
+    // Al llegar a (row, col) desde (row, prevCol) en horizontal, ¿hay un giro vertical forzado?
+    static bool hasForcedNeighbor(const Map& gameMap, int row, int col, int prevCol) {
+        return (passable(gameMap, row - 1, col) && !passable(gameMap, row - 1, prevCol))
+               || (passable(gameMap, row + 1, col) && !passable(gameMap, row + 1, prevCol));
+    }
+
+    // Saltar en horizontal desde (row, col); devuelve la columna del punto de salto o -1
+    static int jumpHorizontal(const Map& gameMap, int row, int col, int dCol, int targetRow, int targetCol) {
+        int prevCol = col;
+        col += dCol;
+        while (passable(gameMap, row, col)) {
+            if (row == targetRow && col == targetCol) return col;
+            if (hasForcedNeighbor(gameMap, row, col, prevCol)) return col;
+            prevCol = col;
+            col += dCol;
+        }
+        return -1;
+    }
+
+    // Saltar en vertical: se detiene donde un salto horizontal encontraría algo; devuelve la fila o -1
+    static int jumpVertical(const Map& gameMap, int row, int col, int dRow, int targetRow, int targetCol) {
+        row += dRow;
+        while (passable(gameMap, row, col)) {
+            if (row == targetRow && col == targetCol) return row;
+            if (jumpHorizontal(gameMap, row, col, 1, targetRow, targetCol) != -1
+                || jumpHorizontal(gameMap, row, col, -1, targetRow, targetCol) != -1) {
+                return row;
+            }
+            row += dRow;
+        }
+        return -1;
+    }
+
+    /*
+     * Búsqueda genérica sobre puntos de salto. jump(row, col, dir, outRow, outCol) devuelve true si
+     * desde (row, col) en la dirección dir se llega a un punto de salto. Cada estado es (celda, dirección
+     * de llegada) porque las direcciones que se podan dependen de cómo se llegó.
+     */
+    template <typename JumpFn>
+    static std::vector<QPoint> search(const Map& gameMap, PathfindingWorkspace& workspace, int startRow, int startCol, int targetRow, int targetCol,
+                                      JumpFn jump, int& expanded) {
+        expanded = 0;
+        // Igual que dijkstraPath: el inicio solo tiene que ser válido, el objetivo además transitable
+        if (!gameMap.isValidIndex(startRow, startCol) || !gameMap.isValidIndex(targetRow, targetCol)) {
+            return {};
+        }
+        if (startRow == targetRow && startCol == targetCol) {
+            return {{startRow, startCol}};
+        }
+        if (!passable(gameMap, targetRow, targetCol)) {
+            return {};
+        }
+
+        const int numCols = gameMap.getNumCols();
+        auto stateOf = [numCols](int row, int col, int dir) { return (row * numCols + col) * 5 + dir; };
+        auto heuristic = [&](int row, int col) { return std::abs(row - targetRow) + std::abs(col - targetCol); };
+
+        workspace.begin(gameMap.getNumCells() * 5);
+        int startState = stateOf(startRow, startCol, NO_DIRECTION);
+        workspace.reach(startState, 0, -1);
+        workspace.pushHeap({startState, 0, heuristic(startRow, startCol)});
+
+        while (!workspace.heapEmpty()) {
+            PathfindingWorkspace::HeapNode current = workspace.popHeap();
+            if (workspace.isClosed(current.node)) continue;
+            workspace.close(current.node);
+            ++expanded;
+
+            int cell = current.node / 5;
+            int arrivedDir = current.node % 5;
+            int row = cell / numCols;
+            int col = cell % numCols;
+
+            if (row == targetRow && col == targetCol) {
+                return buildPath(current.node, workspace, numCols);
+            }
+
+            for (int dir = 0; dir < 4; ++dir) {
+                if (!isSuccessorDirection(gameMap, row, col, arrivedDir, dir)) continue;
+
+                int jumpRow, jumpCol;
+                if (!jump(row, col, dir, jumpRow, jumpCol)) continue;
+
+                int next = stateOf(jumpRow, jumpCol, dir);
+                int newCost = current.cost + std::abs(jumpRow - row) + std::abs(jumpCol - col);
+                if (!workspace.isClosed(next) && newCost < workspace.cost(next)) {
+                    workspace.reach(next, newCost, current.node);
+                    workspace.pushHeap({next, newCost, newCost + heuristic(jumpRow, jumpCol)});
+                }
+            }
+        }
+        return {};
+    }
+
+    // Reglas de poda para 4 direcciones
+    static bool isSuccessorDirection(const Map& gameMap, int row, int col, int arrivedDir, int dir) {
+        if (arrivedDir == NO_DIRECTION) return true;
+        if (dir == (arrivedDir + 2) % 4) return false; // Nunca devolverse
+        if (!isHorizontal(arrivedDir)) return true;    // Tras un tramo vertical se puede girar en cualquier celda
+        if (dir == arrivedDir) return true;
+        // Tramo horizontal: solo se gira a vertical si el vecino está forzado
+        int prevCol = col - DIR_COL[arrivedDir];
+        int sideRow = row + DIR_ROW[dir];
+        return passable(gameMap, sideRow, col) && !passable(gameMap, sideRow, prevCol);
+    }
+
+private:
+    // Reconstruir el camino celda por celda a partir de la cadena de puntos de salto
+    static std::vector<QPoint> buildPath(int state, const PathfindingWorkspace& workspace, int numCols) {
+        std::vector<QPoint> jumpPoints = workspace.buildPath(state, [numCols](int at) {
+            int cell = at / 5;
+            return QPoint(cell / numCols, cell % numCols);
+        });
+
+        std::vector<QPoint> path;
+        path.push_back(jumpPoints.front());
+        for (std::size_t i = 1; i < jumpPoints.size(); ++i) {
+            QPoint from = jumpPoints[i - 1];
+            QPoint to = jumpPoints[i];
+            int stepRow = (to.x() > from.x()) - (to.x() < from.x());
+            int stepCol = (to.y() > from.y()) - (to.y() < from.y());
+            QPoint at = from;
+            while (at != to) {
+                at = {at.x() + stepRow, at.y() + stepCol};
+                path.push_back(at);
+            }
+        }
+        return path;
+    }
+};
+
+/*
+ * Tabla JPS+: para cada celda y dirección, la distancia al siguiente punto de salto
+ * (valor positivo) o la cantidad de celdas libres hasta la pared (cero o negativo).
+ * En vertical, "punto de salto" es una celda desde la que algún salto horizontal encuentra
+ * un vecino forzado; el objetivo se revisa aparte en cada consulta.
+ */
+class JumpPointTable {
+public:
+    explicit JumpPointTable(const Map& gameMap) {
+        rebuild(gameMap);
+    }
+
+    // Reconstruir solo si los obstáculos cambiaron desde la última vez
+    void refresh(const Map& gameMap) {
+        if (gameMap.getObstacleVersion() != builtVersion || gameMap.getNumRows() != rows
+            || gameMap.getNumCols() != cols) {
+            rebuild(gameMap);
+        }
+    }
+
+    void rebuild(const Map& gameMap) {
+        rows = gameMap.getNumRows();
+        cols = gameMap.getNumCols();
+        builtVersion = gameMap.getObstacleVersion();
+        // Las distancias no entran en 16 bits: sin tabla, y jpsPlusPath usa jpsPath
+        if (rows > MAX_SIDE || cols > MAX_SIDE) {
+            distances.clear();
+            distances.shrink_to_fit();
+            return;
+        }
+        distances.assign(static_cast<std::size_t>(rows) * cols * 4, 0);
+
+        // Horizontal: recorrer cada fila desde la pared hacia atrás
+        for (int row = 0; row < rows; ++row) {
+            for (int col = cols - 1; col >= 0; --col) {
+                set(row, col, 0, horizontalStep(gameMap, row, col, 1));
+            }
+            for (int col = 0; col < cols; ++col) {
+                set(row, col, 2, horizontalStep(gameMap, row, col, -1));
+            }
+        }
+
+        // Vertical: depende de los valores horizontales ya calculados
+        for (int col = 0; col < cols; ++col) {
+            for (int row = rows - 1; row >= 0; --row) {
+                set(row, col, 1, verticalStep(gameMap, row, col, 1));
+            }
+            for (int row = 0; row < rows; ++row) {
+                set(row, col, 3, verticalStep(gameMap, row, col, -1));
+            }
+        }
+    }
+
+    // Lado máximo del mapa para el que se arma la tabla
+    static constexpr int MAX_SIDE = INT16_MAX;
+
+    // false si el mapa tiene más filas o columnas que MAX_SIDE
+    bool isAvailable() const { return !distances.empty(); }
+
+    /*
+     * Salto con la tabla, equivalente a JumpPointSearch::jumpHorizontal/jumpVertical.
+     * Además se detiene en la fila del objetivo al ir en vertical, para que el salto horizontal
+     * desde ahí lo pueda encontrar.
+     */
+    bool jump(int row, int col, int dir, int targetRow, int targetCol, int& outRow, int& outCol) const {
+        int value = get(row, col, dir);
+        int reach = value > 0 ? value : -value;
+        int dRow = JumpPointSearch::DIR_ROW[dir];
+        int dCol = JumpPointSearch::DIR_COL[dir];
+
+        if (JumpPointSearch::isHorizontal(dir)) {
+            int toTarget = (targetCol - col) * dCol;
+            if (targetRow == row && toTarget > 0 && toTarget <= reach) {
+                outRow = row;
+                outCol = targetCol;
+                return true;
+            }
+        } else {
+            int toTargetRow = (targetRow - row) * dRow;
+            if (toTargetRow > 0 && toTargetRow <= reach && (value <= 0 || toTargetRow <= value)) {
+                outRow = targetRow;
+                outCol = col;
+                return true;
+            }
+        }
+
+        if (value <= 0) return false;
+        outRow = row + dRow * value;
+        outCol = col + dCol * value;
+        return true;
+    }
+
+    int get(int row, int col, int dir) const {
+        return distances[(static_cast<std::size_t>(row) * cols + col) * 4 + dir];
+    }
+
+private:
+    int rows = 0;
+    int cols = 0;
+    std::uint64_t builtVersion = 0;
+    std::vector<std::int16_t> distances; // Vacío si el mapa supera MAX_SIDE por lado
+
+    void set(int row, int col, int dir, int value) {
+        distances[(static_cast<std::size_t>(row) * cols + col) * 4 + dir] = static_cast<std::int16_t>(value);
+    }
+
+    // Valor para (row, col) en horizontal a partir del de la celda siguiente (ya calculado)
+    int horizontalStep(const Map& gameMap, int row, int col, int dCol) const {
+        int nextCol = col + dCol;
+        if (!JumpPointSearch::passable(gameMap, row, nextCol)) return 0;
+        if (JumpPointSearch::hasForcedNeighbor(gameMap, row, nextCol, col)) return 1;
+        int nextValue = get(row, nextCol, dCol > 0 ? 0 : 2);
+        return nextValue > 0 ? nextValue + 1 : nextValue - 1;
+    }
+
+    int verticalStep(const Map& gameMap, int row, int col, int dRow) const {
+        int nextRow = row + dRow;
+        if (!JumpPointSearch::passable(gameMap, nextRow, col)) return 0;
+        if (get(nextRow, col, 0) > 0 || get(nextRow, col, 2) > 0) return 1;
+        int nextValue = get(nextRow, col, dRow > 0 ? 1 : 3);
+        return nextValue > 0 ? nextValue + 1 : nextValue - 1;
+    }
+};
+
+#endif // JUMPPOINTSEARCH_H
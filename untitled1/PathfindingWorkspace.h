@@ -0,0 +1,119 @@
+#ifndef PATHFINDINGWORKSPACE_H
+#define PATHFINDINGWORKSPACE_H
+
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+#include <QPoint>
+
+/*
+ * Memoria reutilizable para las búsquedas de Pathfinding. Todos los arreglos son planos
+ * (un nodo por índice) y se marcan con un número de generación: empezar una búsqueda nueva
+ * solo incrementa la generación, así que no hay que limpiar nada entre consultas y después
+ * de la primera búsqueda en un mapa no se vuelve a pedir memoria.
+ *
+ * Si tiene una bandera de cancelación, las búsquedas la miran cada tanto y se rinden (camino
+ * vacío) cuando otro hilo la prende.
+ */
+class PathfindingWorkspace {
+public:
+    static constexpr int UNREACHED = std::numeric_limits<int>::max();
+
+    struct HeapNode {
+        int node;
+        int cost;     // g: costo desde el inicio
+        int estimate; // f = g + h (en Dijkstra es igual al costo)
+        bool operator<(const HeapNode& other) const {
+            if (estimate != other.estimate) {
+                return estimate > other.estimate; // Menor f tiene prioridad
+            }
+            return cost < other.cost; // En empate, el nodo más avanzado primero
+        }
+    };
+
+    // Preparar para una búsqueda sobre numNodes nodos
+    void begin(int numNodes) {
+        if (static_cast<int>(seenStamp.size()) < numNodes) {
+            seenStamp.resize(numNodes, 0);
+            closedStamp.resize(numNodes, 0);
+            costs.resize(numNodes, 0);
+            parents.resize(numNodes, -1);
+        }
+        ++generation;
+        if (generation == 0) {
+            // Se dio la vuelta el contador: limpiar una sola vez y seguir
+            std::fill(seenStamp.begin(), seenStamp.end(), 0);
+            std::fill(closedStamp.begin(), closedStamp.end(), 0);
+            generation = 1;
+        }
+        fifo.clear();
+        fifoHead = 0;
+        heap.clear();
+    }
+
+    // Bandera que otro hilo puede prender para abandonar la búsqueda (nullptr = no se cancela)
+    void setCancelFlag(const std::atomic<bool>* flag) { cancelFlag = flag; }
+    bool isCancelled() const { return cancelFlag && cancelFlag->load(std::memory_order_relaxed); }
+
+    bool isSeen(int node) const { return seenStamp[node] == generation; }
+    bool isClosed(int node) const { return closedStamp[node] == generation; }
+    void close(int node) { closedStamp[node] = generation; }
+
+    int cost(int node) const { return isSeen(node) ? costs[node] : UNREACHED; }
+    int parent(int node) const { return isSeen(node) ? parents[node] : -1; }
+
+    void reach(int node, int nodeCost, int parentNode) {
+        seenStamp[node] = generation;
+        costs[node] = nodeCost;
+        parents[node] = parentNode;
+    }
+
+    // Cola FIFO para BFS (se vacía con begin)
+    void pushFifo(int node) { fifo.push_back(node); }
+    bool fifoEmpty() const { return fifoHead >= fifo.size(); }
+    int popFifo() { return fifo[fifoHead++]; }
+
+    // Montículo para Dijkstra / A* / JPS (se vacía con begin)
+    void pushHeap(const HeapNode& entry) {
+        heap.push_back(entry);
+        std::push_heap(heap.begin(), heap.end());
+    }
+    bool heapEmpty() const { return heap.empty(); }
+    HeapNode popHeap() {
+        std::pop_heap(heap.begin(), heap.end());
+        HeapNode top = heap.back();
+        heap.pop_back();
+        return top;
+    }
+
+    // Camino desde el inicio hasta `node` siguiendo los padres; toNode convierte el índice en QPoint
+    template <typename ToPoint>
+    std::vector<QPoint> buildPath(int node, ToPoint toPoint) const {
+        std::vector<QPoint> path;
+        for (int at = node; at != -1; at = parent(at)) {
+            path.push_back(toPoint(at));
+        }
+        std::reverse(path.begin(), path.end());
+        return path;
+    }
+
+    // Caso común: los nodos son celdas fila * numCols + columna
+    std::vector<QPoint> buildCellPath(int node, int numCols) const {
+        return buildPath(node, [numCols](int cell) { return QPoint(cell / numCols, cell % numCols); });
+    }
+
+private:
+    std::uint32_t generation = 0;
+    std::vector<std::uint32_t> seenStamp;
+    std::vector<std::uint32_t> closedStamp;
+    std::vector<int> costs;
+    std::vector<int> parents;
+    std::vector<int> fifo;
+    std::size_t fifoHead = 0;
+    std::vector<HeapNode> heap;
+    const std::atomic<bool>* cancelFlag = nullptr;
+};
+
+#endif // PATHFINDINGWORKSPACE_H
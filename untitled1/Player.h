@@ -2,11 +2,13 @@
 #define PLAYER_H
 
 #include <QColor>
+#include <QSet>
 #include "Tank.h"
 
 class Player {
 private:
     QList<Tank*> tanks;
+    QSet<const Tank*> tankSet; // Para saber en tiempo constante si un tanque es de este jugador
     bool isTurn;
 
 public:
@@ -15,6 +17,7 @@ public:
     void addTank(Tank* tank) {
         if (tank != nullptr && !ownsTank(tank)) {
             tanks.append(tank);
+            tankSet.insert(tank);
         }
     }
 
@@ -23,7 +26,7 @@ public:
     }
 
     bool ownsTank(Tank* tank) const {
-        return tanks.contains(tank);
+        return tankSet.contains(tank);
     }
 
     void setTurn(bool turn) {
@@ -0,0 +1,111 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <cstdint>
+#include <random>
+#include <limits>
+
+/*
+ * Generador aleatorio del juego: xoshiro256** sembrado con splitmix64.
+ *
+ * Es un objeto normal que se pasa a quien lo necesita (nada de generadores globales), así que
+ * cada partida se repite igual con la misma semilla y las simulaciones en paralelo no compiten
+ * por un generador compartido. Con stream() se sacan secuencias independientes de una misma
+ * semilla, una por subsistema, para que un cambio en uno no altere los números de los demás.
+ *
+ * Cumple UniformRandomBitGenerator, así que también sirve con std::shuffle y las distribuciones
+ * de <random>.
+ */
+
+// Subsistemas con secuencia propia dentro de una partida
+enum class RngStream : std::uint64_t {
+    Map = 1,       // Obstáculos
+    Placement = 2, // Posición inicial de los tanques
+    Movement = 3,  // Elección entre algoritmo y movimiento aleatorio, y el movimiento aleatorio
+    Ai = 4         // Decisiones de los jugadores automáticos
+};
+
+class Rng {
+public:
+    using result_type = std::uint64_t;
+
+    explicit Rng(std::uint64_t seed = 0) { reseed(seed); }
+
+    // Secuencia independiente para un subsistema de la partida con esta semilla
+    static Rng stream(std::uint64_t seed, RngStream subsystem) {
+        std::uint64_t mixed = seed;
+        mixed = splitmix64(mixed) ^ (static_cast<std::uint64_t>(subsystem) * 0x9E3779B97F4A7C15ULL);
+        return Rng(mixed);
+    }
+
+    // Semilla no determinista, para cuando no se pide una (se usa una vez por partida, no por jugada)
+    static std::uint64_t randomSeed() {
+        std::random_device device;
+        return (static_cast<std::uint64_t>(device()) << 32) ^ device();
+    }
+
+    // Generador por hilo para el código que no recibe uno explícito
+    static Rng& threadLocal() {
+        thread_local Rng rng(randomSeed());
+        return rng;
+    }
+
+    void reseed(std::uint64_t seed) {
+        std::uint64_t x = seed;
+        for (std::uint64_t& word : state) {
+            word = splitmix64(x);
+        }
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() { return next(); }
+
+    std::uint64_t next() {
+        const std::uint64_t result = rotl(state[1] * 5, 7) * 9;
+        const std::uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    // Entero uniforme en [0, bound) sin sesgo (método de Lemire); bound debe ser positivo
+    int bounded(int bound) {
+        std::uint64_t range = static_cast<std::uint32_t>(bound);
+        std::uint64_t product = (next() >> 32) * range;
+        std::uint32_t low = static_cast<std::uint32_t>(product);
+        if (low < range) {
+            std::uint32_t threshold = static_cast<std::uint32_t>(-static_cast<std::uint32_t>(range)) % range;
+            while (low < threshold) {
+                product = (next() >> 32) * range;
+                low = static_cast<std::uint32_t>(product);
+            }
+        }
+        return static_cast<int>(product >> 32);
+    }
+
+    // Entero uniforme en [low, high), igual que QRandomGenerator::bounded(low, high)
+    int bounded(int low, int high) { return low + bounded(high - low); }
+
+    // true con probabilidad percent / 100
+    bool chance(int percent) { return bounded(100) < percent; }
+
+private:
+    std::uint64_t state[4];
+
+    static std::uint64_t rotl(std::uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    static std::uint64_t splitmix64(std::uint64_t& x) {
+        std::uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+};
+
+#endif // RNG_H
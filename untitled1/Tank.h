@@ -4,23 +4,31 @@
 #include <QGraphicsEllipseItem>
 #include <QGraphicsScene>
 #include <QColor>
+#include "TankRegistry.h"
 
+/*
+ * Figura de un tanque. Posición y vida no se copian: se leen del TankRegistry de la simulación
+ * con un TankRef, así que lo que muestra el HUD es siempre lo que tiene la partida. La figura va
+ * por su cuenta (setCell / updatePosition) porque la mueve una animación.
+ */
 class Tank {
 private:
-    int row;
-    int col;
+    TankRef state;
     QColor color;
     QGraphicsEllipseItem *tankItem;
     QGraphicsScene *scene;
     static const int tileSize = 50;
-    int currentHealth;
-    int maxHealth;
 
 public:
-    Tank(int row, int col, const QColor& color, QGraphicsScene *scene, int maxHealth)
-        : row(row), col(col), color(color), scene(scene), maxHealth(maxHealth), currentHealth(maxHealth) {
-        tankItem = scene->addEllipse(col * tileSize + 10, row * tileSize + 10, tileSize - 20, tileSize - 20,
-                                      QPen(Qt::NoPen), QBrush(color));
+    Tank(const TankRef& state, const QColor& color, QGraphicsScene *scene)
+        : state(state), color(color), scene(scene) {
+        int row = state.getRow();
+        int col = state.getCol();
+        // El círculo queda fijo en coordenadas del item y se mueve con setPos: moverlo no cambia su
+        // forma, así que se repinta desde el caché en vez de volver a dibujarse
+        tankItem = scene->addEllipse(0, 0, tileSize - 20, tileSize - 20, QPen(Qt::NoPen), QBrush(color));
+        tankItem->setCacheMode(QGraphicsItem::DeviceCoordinateCache);
+        tankItem->setPos(itemPosition(row, col));
         tankItem->setData(0, row); // fila
         tankItem->setData(1, col); // columna
     }
@@ -30,11 +38,15 @@ public:
     }
 
     int getRow() const {
-        return row;
+        return state.getRow();
     }
 
     int getCol() const {
-        return col;
+        return state.getCol();
+    }
+
+    TankHandle getHandle() const {
+        return state.getHandle();
     }
 
     void setColor(const QColor& newColor) {
@@ -47,42 +59,33 @@ public:
         return color;
     }
 
+    // Poner la figura en la celda (el tanque ya se movió en la simulación)
     void updatePosition(int newRow, int newCol) {
-        row = newRow;
-        col = newCol;
-        tankItem->setRect(col * tileSize + 10, row * tileSize + 10, tileSize - 20, tileSize - 20);
-        tankItem->setData(0, row);
-        tankItem->setData(1, col);
+        setCell(newRow, newCol);
+        tankItem->setPos(itemPosition(newRow, newCol));
     }
 
-    /*depende de como trabajemos la vida podemos tratar lo del health distinto
-     */
-    int getHealth() const {
-        return currentHealth;
+    // Cambiar la celda de la figura sin moverla (la mueve una animación)
+    void setCell(int newRow, int newCol) {
+        tankItem->setData(0, newRow);
+        tankItem->setData(1, newCol);
+    }
 
+    // Posición de la figura cuando el tanque está en la celda
+    static QPointF itemPosition(int row, int col) {
+        return QPointF(col * tileSize + 10, row * tileSize + 10);
     }
 
-    /*or ejemplo, aquí se le debe de pasar una cantidad de daño y el mae atualiza lo que le pase
-     *Tmb si la vida se reduce a menos de cero, se ajusta a cero, esto tmb, depende del enfoque podriamos cambiarlo a q si llega a 0 o lleg a menos de 0 tenga un booleano como "alive" o "dead"
-     *creo que tmb voy a hacer eso de una vez
-     */
-    void takeDamage(int damage) {
-        if (currentHealth > 0) {
-            currentHealth -= damage;
-            if ( currentHealth< 0) {
-                currentHealth = 0;
-            }
-        }
+    int getHealth() const {
+        return state.getHealth();
     }
+
     bool isDestroyed() const {
-        return currentHealth <= 0;
-    }
-    int getMaxHealth() const {
-        return maxHealth;
+        return state.isDestroyed();
     }
 
-    void resetHealth() {
-        currentHealth = maxHealth;
+    int getMaxHealth() const {
+        return state.getMaxHealth();
     }
 };
 
@@ -0,0 +1,120 @@
+#ifndef TANKANIMATOR_H
+#define TANKANIMATOR_H
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QGraphicsItem>
+#include <QPointF>
+
+/*
+ * Animación de los tanques sobre su ruta con un bucle de paso fijo: un QTimer despierta cada
+ * ~16 ms, el tiempo real transcurrido se acumula y la lógica avanza en pasos exactos de STEP
+ * segundos (igual en una máquina lenta que en una rápida). Al dibujar se interpola entre el último
+ * paso y el anterior con lo que sobró del acumulador, así el movimiento se ve continuo aunque el
+ * timer no caiga justo en cada paso.
+ *
+ * Todas las animaciones activas avanzan y se mueven en la misma pasada (un setPos por tanque por
+ * cuadro), y el timer se detiene cuando no queda ninguna. La simulación ya movió al tanque: esto
+ * solo es lo que se ve, así que la ventana sigue recibiendo clics mientras tanto.
+ */
+class TankAnimator {
+public:
+    static constexpr double STEP = 1.0 / 60.0;         // Segundos por paso de la lógica
+    static constexpr double CELLS_PER_SECOND = 8.0;
+    static const int FRAME_INTERVAL_MS = 16;
+    static const int MAX_STEPS_PER_FRAME = 5;           // Si la ventana se trabó, no recuperar todo de golpe
+
+    TankAnimator() {
+        timer.setTimerType(Qt::PreciseTimer);
+        timer.setInterval(FRAME_INTERVAL_MS);
+        QObject::connect(&timer, &QTimer::timeout, [this]() { tick(); });
+    }
+
+    /*
+     * Recorrer `waypoints` (posiciones del item en la escena, una por celda de la ruta). Si el item
+     * ya se estaba moviendo, la nueva animación sale desde donde está ahora.
+     */
+    void animate(QGraphicsItem *item, std::vector<QPointF> waypoints) {
+        if (waypoints.empty()) return;
+        auto running = std::find_if(animations.begin(), animations.end(), [item](const Animation& a) { return a.item == item; });
+        if (running != animations.end()) animations.erase(running);
+        // La primera celda de la ruta es donde estaba el tanque; se sale desde donde se ve ahora
+        if (waypoints.size() == 1) {
+            waypoints.insert(waypoints.begin(), item->pos());
+        } else {
+            waypoints.front() = item->pos();
+        }
+        animations.push_back({item, std::move(waypoints), 0.0, 0.0});
+        if (!timer.isActive()) {
+            accumulator = 0.0;
+            clock.start();
+            timer.start();
+        }
+    }
+
+    // Dejar de animar un item (por ejemplo antes de borrarlo)
+    void cancel(QGraphicsItem *item) {
+        animations.erase(std::remove_if(animations.begin(), animations.end(), [item](const Animation& a) { return a.item == item; }),
+                         animations.end());
+    }
+
+    // Llevar todo a su posición final ya
+    void finishAll() {
+        for (Animation& animation : animations) {
+            animation.item->setPos(animation.waypoints.back());
+        }
+        animations.clear();
+        timer.stop();
+    }
+
+    bool isAnimating() const { return !animations.empty(); }
+
+private:
+    struct Animation {
+        QGraphicsItem *item;
+        std::vector<QPointF> waypoints;
+        double previous; // Celdas recorridas en el paso anterior
+        double current;  // Celdas recorridas en este paso
+    };
+
+    QTimer timer;
+    QElapsedTimer clock;
+    double accumulator = 0.0;
+    std::vector<Animation> animations;
+
+    void tick() {
+        accumulator += clock.restart() / 1000.0;
+        accumulator = std::min(accumulator, STEP * MAX_STEPS_PER_FRAME);
+        while (accumulator >= STEP) {
+            for (Animation& animation : animations) {
+                animation.previous = animation.current;
+                animation.current = std::min(animation.current + CELLS_PER_SECOND * STEP,
+                                             static_cast<double>(animation.waypoints.size() - 1));
+            }
+            accumulator -= STEP;
+        }
+
+        double alpha = accumulator / STEP;
+        for (Animation& animation : animations) {
+            animation.item->setPos(positionAt(animation, animation.previous + (animation.current - animation.previous) * alpha));
+        }
+        animations.erase(std::remove_if(animations.begin(), animations.end(), [](const Animation& a) {
+                             return a.previous >= static_cast<double>(a.waypoints.size() - 1);
+                         }),
+                         animations.end());
+        if (animations.empty()) timer.stop();
+    }
+
+    static QPointF positionAt(const Animation& animation, double progress) {
+        std::size_t last = animation.waypoints.size() - 1;
+        std::size_t from = std::min(static_cast<std::size_t>(progress), last);
+        if (from == last) return animation.waypoints.back();
+        double t = progress - static_cast<double>(from);
+        return animation.waypoints[from] + (animation.waypoints[from + 1] - animation.waypoints[from]) * t;
+    }
+};
+
+#endif // TANKANIMATOR_H
@@ -0,0 +1,219 @@
+#ifndef TANKREGISTRY_H
+#define TANKREGISTRY_H
+
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+
+// El color decide el jugador y el algoritmo de movimiento del tanque
+enum class TankColor : std::uint8_t { Red, Blue, Yellow, Cyan };
+
+// Referencia estable a un tanque: índice del espacio y generación (detecta espacios reutilizados)
+struct TankHandle {
+    static const std::uint32_t INVALID_INDEX = 0xFFFFFFFFu;
+    std::uint32_t index = INVALID_INDEX;
+    std::uint32_t generation = 0;
+
+    bool isNull() const { return index == INVALID_INDEX; }
+    bool operator==(const TankHandle& other) const { return index == other.index && generation == other.generation; }
+};
+
+class TankRegistry;
+
+/*
+ * Vista de solo lectura de un tanque del registro con los getters de Tank (getRow, getHealth, ...),
+ * para que el código escrito contra Tank siga funcionando sin copiar sus datos. Los cambios pasan
+ * por quien es dueño del registro (GameSimulation). Si el handle ya no vale (otra partida), el
+ * tanque se ve destruido y fuera del mapa.
+ */
+class TankRef {
+public:
+    TankRef(const TankRegistry& registry, TankHandle handle) : registry(&registry), handle(handle) {}
+
+    bool isValid() const;
+    TankHandle getHandle() const { return handle; }
+    int getRow() const;
+    int getCol() const;
+    TankColor getColor() const;
+    int getTeam() const;
+    int getHealth() const;
+    int getMaxHealth() const;
+    bool isDestroyed() const;
+
+private:
+    const TankRegistry* registry;
+    TankHandle handle;
+};
+
+/*
+ * Tanques guardados como estructura de arreglos: posición, vida, equipo, color y banderas en
+ * arreglos contiguos, uno por campo. Las operaciones sobre muchos tanques (daño de área,
+ * conteos, puntajes de la IA) son recorridos lineales sin punteros que el compilador puede
+ * vectorizar. clear() sube la generación de cada espacio, así que los handles de la partida
+ * anterior dejan de ser válidos aunque el espacio vuelva a usarse.
+ */
+class TankRegistry {
+public:
+    enum Flags : std::uint8_t {
+        IN_USE = 1 << 0, // El espacio tiene un tanque
+        ALIVE = 1 << 1   // Tiene vida
+    };
+
+    TankHandle add(int row, int col, TankColor color, int team, int maxHealth) {
+        std::uint32_t index = static_cast<std::uint32_t>(rows.size());
+        rows.push_back(0);
+        cols.push_back(0);
+        health.push_back(0);
+        maxHealths.push_back(0);
+        teams.push_back(0);
+        colors.push_back(0);
+        flags.push_back(0);
+        if (index == generations.size()) generations.push_back(0);
+        rows[index] = row;
+        cols[index] = col;
+        health[index] = maxHealth;
+        maxHealths[index] = maxHealth;
+        teams[index] = static_cast<std::uint8_t>(team);
+        colors[index] = static_cast<std::uint8_t>(color);
+        flags[index] = IN_USE | (maxHealth > 0 ? ALIVE : 0);
+        ++count;
+        return {index, generations[index]};
+    }
+
+    void clear() {
+        rows.clear();
+        cols.clear();
+        health.clear();
+        maxHealths.clear();
+        teams.clear();
+        colors.clear();
+        flags.clear();
+        for (std::uint32_t& generation : generations) ++generation;
+        count = 0;
+    }
+
+    bool isValid(TankHandle handle) const {
+        return handle.index < flags.size() && (flags[handle.index] & IN_USE) && generations[handle.index] == handle.generation;
+    }
+
+    TankHandle handle(std::uint32_t index) const {
+        if (index >= flags.size() || !(flags[index] & IN_USE)) return {};
+        return {index, generations[index]};
+    }
+
+    TankRef ref(TankHandle handle) const { return TankRef(*this, handle); }
+
+    // Cantidad de espacios (incluye los libres); los índices válidos van de 0 a slots() - 1
+    std::size_t slots() const { return flags.size(); }
+    int size() const { return count; }
+
+    bool inUse(std::uint32_t i) const { return flags[i] & IN_USE; }
+    bool isAlive(std::uint32_t i) const { return flags[i] & ALIVE; }
+    int row(std::uint32_t i) const { return rows[i]; }
+    int col(std::uint32_t i) const { return cols[i]; }
+    int healthOf(std::uint32_t i) const { return health[i]; }
+    int maxHealthOf(std::uint32_t i) const { return maxHealths[i]; }
+    int team(std::uint32_t i) const { return teams[i]; }
+    TankColor color(std::uint32_t i) const { return static_cast<TankColor>(colors[i]); }
+
+    void setPosition(std::uint32_t i, int row, int col) {
+        rows[i] = row;
+        cols[i] = col;
+    }
+
+    // Quitar vida a un tanque; devuelve true si con esto quedó destruido
+    bool damage(std::uint32_t i, int amount) {
+        if (!(flags[i] & ALIVE) || amount <= 0) return false;
+        health[i] = std::max(0, health[i] - amount);
+        if (health[i] == 0) {
+            flags[i] &= static_cast<std::uint8_t>(~ALIVE);
+            return true;
+        }
+        return false;
+    }
+
+    void resetHealth(std::uint32_t i) {
+        health[i] = maxHealths[i];
+        if (flags[i] & IN_USE) flags[i] |= ALIVE;
+    }
+
+    /*
+     * Daño a todos los tanques vivos a distancia Manhattan <= radius de (row, col). El cálculo es
+     * una pasada sin saltos sobre los arreglos; después se actualizan las banderas. Si se pasa
+     * `destroyed`, ahí quedan los índices de los tanques que murieron.
+     */
+    int applyAreaDamage(int row, int col, int radius, int amount, std::vector<std::uint32_t>* destroyed = nullptr) {
+        const std::size_t n = flags.size();
+        int hits = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            int distance = std::abs(rows[i] - row) + std::abs(cols[i] - col);
+            int hit = (distance <= radius) & ((flags[i] & ALIVE) != 0);
+            health[i] = std::max(0, health[i] - hit * amount);
+            hits += hit;
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            if ((flags[i] & ALIVE) && health[i] == 0) {
+                flags[i] &= static_cast<std::uint8_t>(~ALIVE);
+                if (destroyed) destroyed->push_back(static_cast<std::uint32_t>(i));
+            }
+        }
+        return hits;
+    }
+
+    int countAlive(int team) const {
+        int total = 0;
+        for (std::size_t i = 0; i < flags.size(); ++i) {
+            total += ((flags[i] & ALIVE) != 0) & (teams[i] == team);
+        }
+        return total;
+    }
+
+    int totalHealth(int team) const {
+        int total = 0;
+        for (std::size_t i = 0; i < flags.size(); ++i) {
+            total += (teams[i] == team && (flags[i] & IN_USE)) ? health[i] : 0;
+        }
+        return total;
+    }
+
+    // Distancia Manhattan al tanque vivo más cercano de otro equipo (-1 si no hay), para puntajes de la IA
+    int nearestEnemyDistance(int row, int col, int team) const {
+        int best = -1;
+        for (std::size_t i = 0; i < flags.size(); ++i) {
+            if (!(flags[i] & ALIVE) || teams[i] == team) continue;
+            int distance = std::abs(rows[i] - row) + std::abs(cols[i] - col);
+            if (best < 0 || distance < best) best = distance;
+        }
+        return best;
+    }
+
+    template <typename Fn>
+    void forEachAlive(Fn fn) const {
+        for (std::size_t i = 0; i < flags.size(); ++i) {
+            if (flags[i] & ALIVE) fn(static_cast<std::uint32_t>(i));
+        }
+    }
+
+private:
+    std::vector<int> rows;
+    std::vector<int> cols;
+    std::vector<int> health;
+    std::vector<int> maxHealths;
+    std::vector<std::uint8_t> teams;
+    std::vector<std::uint8_t> colors;
+    std::vector<std::uint8_t> flags;
+    std::vector<std::uint32_t> generations; // No se vacía con clear(): sigue contando entre partidas
+    int count = 0;
+};
+
+inline bool TankRef::isValid() const { return registry->isValid(handle); }
+inline int TankRef::getRow() const { return isValid() ? registry->row(handle.index) : -1; }
+inline int TankRef::getCol() const { return isValid() ? registry->col(handle.index) : -1; }
+inline TankColor TankRef::getColor() const { return isValid() ? registry->color(handle.index) : TankColor::Red; }
+inline int TankRef::getTeam() const { return isValid() ? registry->team(handle.index) : -1; }
+inline int TankRef::getHealth() const { return isValid() ? registry->healthOf(handle.index) : 0; }
+inline int TankRef::getMaxHealth() const { return isValid() ? registry->maxHealthOf(handle.index) : 0; }
+inline bool TankRef::isDestroyed() const { return !isValid() || !registry->isAlive(handle.index); }
+
+#endif // TANKREGISTRY_H
@@ -0,0 +1,284 @@
+#ifndef TILELAYERITEM_H
+#define TILELAYERITEM_H
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <QGraphicsItem>
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include <QPixmap>
+#include <QImage>
+#include <QColor>
+#include <QPen>
+#include "Graph.h"
+
+/*
+ * La cuadrícula del mapa como un solo item de la escena, en vez de un QGraphicsRectItem por celda.
+ * paint() dibuja solo las celdas dentro del rectángulo expuesto, copiando una de tres baldosas ya
+ * dibujadas (libre, obstáculo, filas negras de abajo), así que el costo depende de lo que se ve y
+ * no del tamaño del mapa. Por celda solo se guarda un byte con el tipo de baldosa.
+ *
+ * syncWithMap() lee el registro de cambios del mapa y pide repintar solo las celdas cuyo tipo cambió.
+ *
+ * Con poco zoom (menos de DETAIL_MIN_PIXELS píxeles por celda) los bordes no se distinguen y dibujar
+ * una baldosa por celda cuesta lo mismo que el mapa entero. Entonces se dibuja una imagen de a lo más
+ * un píxel por bloque de 2^k x 2^k celdas, con el color promedio del bloque (y blanco si hay algún
+ * tanque). Los promedios salen de una pirámide de conteos por bloque (obstáculos, filas negras,
+ * celdas ocupadas) que se corrige en O(log) por celda cambiada, así que también con el mapa entero
+ * a la vista el costo depende de los píxeles en pantalla y no de las celdas.
+ */
+class TileLayerItem : public QGraphicsItem {
+public:
+    static constexpr qreal DETAIL_MIN_PIXELS = 8.0; // Desde aquí se dibujan baldosas con borde y tanques
+
+    TileLayerItem(const Map& gameMap, int tileSize, int hudRows = 2, QGraphicsItem *parent = nullptr)
+        : QGraphicsItem(parent), gameMap(gameMap), tileSize(tileSize), hudRows(hudRows) {
+        setFlag(QGraphicsItem::ItemUsesExtendedStyleOption); // Para recibir exposedRect en paint()
+        buildTiles();
+        rebuild();
+    }
+
+    QRectF boundingRect() const override {
+        return QRectF(0, 0, static_cast<qreal>(cols) * tileSize, static_cast<qreal>(rows) * tileSize);
+    }
+
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *) override {
+        QRectF exposed = option->exposedRect.intersected(boundingRect());
+        if (exposed.isEmpty()) return;
+        qreal pixelsPerTile = tileSize * QStyleOptionGraphicsItem::levelOfDetailFromTransform(painter->worldTransform());
+        if (pixelsPerTile < DETAIL_MIN_PIXELS) {
+            paintAggregated(painter, exposed, pixelsPerTile);
+            return;
+        }
+        int firstRow = std::max(0, static_cast<int>(exposed.top()) / tileSize);
+        int lastRow = std::min(rows - 1, static_cast<int>(exposed.bottom()) / tileSize);
+        int firstCol = std::max(0, static_cast<int>(exposed.left()) / tileSize);
+        int lastCol = std::min(cols - 1, static_cast<int>(exposed.right()) / tileSize);
+        for (int row = firstRow; row <= lastRow; ++row) {
+            const std::uint8_t* cell = &cells[static_cast<std::size_t>(row) * cols];
+            for (int col = firstCol; col <= lastCol; ++col) {
+                painter->drawPixmap(col * tileSize, row * tileSize, tiles[cell[col] & KIND_MASK]);
+            }
+        }
+    }
+
+    // Si con esta escala (píxeles por unidad de escena) se dibujan baldosas y tanques o solo colores por bloque
+    bool isDetailed(qreal scale) const { return tileSize * scale >= DETAIL_MIN_PIXELS; }
+
+    // Repintar las celdas que cambiaron de tipo desde la última vez
+    void syncWithMap() {
+        if (gameMap.getNumRows() != rows || gameMap.getNumCols() != cols) {
+            rebuild();
+            return;
+        }
+        if (gameMap.getVersion() == syncedVersion) return;
+        changed.clear();
+        if (!gameMap.changesSince(syncedVersion, changed)) {
+            rebuild();
+            return;
+        }
+        for (const QPoint& at : changed) {
+            std::uint8_t& cell = cells[static_cast<std::size_t>(at.x()) * cols + at.y()];
+            std::uint8_t current = cellStateAt(at.x(), at.y());
+            if (cell == current) continue;
+            addToPyramid(at.x(), at.y(), cell, -1);
+            addToPyramid(at.x(), at.y(), current, 1);
+            // Si solo cambió la ocupación las baldosas se ven igual, pero los bloques con poco zoom no
+            if ((cell & KIND_MASK) != (current & KIND_MASK)) ++dirtyTiles;
+            cell = current;
+            update(at.y() * tileSize, at.x() * tileSize, tileSize, tileSize);
+        }
+        syncedVersion = gameMap.getVersion();
+    }
+
+    // Volver a leer todo el mapa (después de cambios masivos o de cambiar de tamaño)
+    void rebuild() {
+        if (gameMap.getNumRows() != rows || gameMap.getNumCols() != cols) {
+            prepareGeometryChange();
+            rows = gameMap.getNumRows();
+            cols = gameMap.getNumCols();
+        }
+        cells.resize(static_cast<std::size_t>(rows) * cols);
+        for (int row = 0; row < rows; ++row) {
+            for (int col = 0; col < cols; ++col) {
+                cells[static_cast<std::size_t>(row) * cols + col] = cellStateAt(row, col);
+            }
+        }
+        buildPyramid();
+        syncedVersion = gameMap.getVersion();
+        update();
+    }
+
+    // Celdas repintadas por cambios desde que se creó el item
+    long long getDirtyTiles() const { return dirtyTiles; }
+
+private:
+    enum TileKind : std::uint8_t { FreeTile, ObstacleTile, HudTile, TILE_KINDS };
+    static const std::uint8_t KIND_MASK = 0x7F;
+    static const std::uint8_t OCCUPIED = 0x80; // Bit de celda con tanque, junto al tipo de baldosa
+
+    // Conteos de un nivel de la pirámide: bloques de 2^nivel x 2^nivel celdas
+    struct BlockLevel {
+        int rows = 0;
+        int cols = 0;
+        std::vector<std::uint32_t> obstacles;
+        std::vector<std::uint32_t> hud;
+        std::vector<std::uint32_t> occupied;
+    };
+
+    const Map& gameMap;
+    int tileSize;
+    int hudRows; // Filas de abajo reservadas para los textos de vida
+    int rows = 0;
+    int cols = 0;
+    std::uint64_t syncedVersion = 0;
+    std::vector<std::uint8_t> cells; // Tipo de baldosa | OCCUPIED
+    std::vector<BlockLevel> levels;  // levels[k] = bloques de 2^k; levels[0] queda vacío (se usa `cells`)
+    QImage blockImage;               // Se reutiliza entre cuadros con poco zoom
+    std::vector<QPoint> changed;
+    QPixmap tiles[TILE_KINDS];
+    long long dirtyTiles = 0;
+
+    std::uint8_t cellStateAt(int row, int col) const {
+        if (row >= rows - hudRows) return HudTile;
+        int state = gameMap.cellAt(row, col);
+        if (state == Map::OBSTACLE) return ObstacleTile;
+        return state == Map::PATH ? (FreeTile | OCCUPIED) : FreeTile;
+    }
+
+    static QColor tileColor(std::uint8_t kind) {
+        switch (kind) {
+            case ObstacleTile: return QColor(139, 115, 85);
+            case HudTile: return Qt::black;
+            case FreeTile:
+            default: return QColor(210, 180, 140);
+        }
+    }
+
+    void buildPyramid() {
+        levels.assign(1, BlockLevel());
+        for (int level = 1;; ++level) {
+            int finerRows = level == 1 ? rows : levels.back().rows;
+            int finerCols = level == 1 ? cols : levels.back().cols;
+            if (finerRows <= 1 && finerCols <= 1) break; // El nivel anterior ya es un solo bloque
+            BlockLevel next;
+            next.rows = (rows + (1 << level) - 1) >> level;
+            next.cols = (cols + (1 << level) - 1) >> level;
+            std::size_t blocks = static_cast<std::size_t>(next.rows) * next.cols;
+            next.obstacles.assign(blocks, 0);
+            next.hud.assign(blocks, 0);
+            next.occupied.assign(blocks, 0);
+            if (level == 1) {
+                for (int row = 0; row < rows; ++row) {
+                    for (int col = 0; col < cols; ++col) {
+                        std::uint8_t cell = cells[static_cast<std::size_t>(row) * cols + col];
+                        std::size_t block = static_cast<std::size_t>(row >> 1) * next.cols + (col >> 1);
+                        next.obstacles[block] += (cell & KIND_MASK) == ObstacleTile;
+                        next.hud[block] += (cell & KIND_MASK) == HudTile;
+                        next.occupied[block] += (cell & OCCUPIED) != 0;
+                    }
+                }
+            } else {
+                const BlockLevel& prev = levels.back();
+                for (int row = 0; row < prev.rows; ++row) {
+                    for (int col = 0; col < prev.cols; ++col) {
+                        std::size_t from = static_cast<std::size_t>(row) * prev.cols + col;
+                        std::size_t block = static_cast<std::size_t>(row >> 1) * next.cols + (col >> 1);
+                        next.obstacles[block] += prev.obstacles[from];
+                        next.hud[block] += prev.hud[from];
+                        next.occupied[block] += prev.occupied[from];
+                    }
+                }
+            }
+            levels.push_back(std::move(next));
+        }
+    }
+
+    // Sumar (delta = 1) o restar (delta = -1) una celda en todos los niveles
+    void addToPyramid(int row, int col, std::uint8_t cell, int delta) {
+        for (std::size_t level = 1; level < levels.size(); ++level) {
+            BlockLevel& blocks = levels[level];
+            std::size_t block = static_cast<std::size_t>(row >> level) * blocks.cols + (col >> level);
+            if ((cell & KIND_MASK) == ObstacleTile) blocks.obstacles[block] += delta;
+            if ((cell & KIND_MASK) == HudTile) blocks.hud[block] += delta;
+            if (cell & OCCUPIED) blocks.occupied[block] += delta;
+        }
+    }
+
+    /*
+     * Un píxel de imagen por bloque de 2^level celdas, con el nivel más fino cuyo bloque ocupe al
+     * menos un píxel en pantalla; la imagen se estira sobre el área expuesta sin suavizado.
+     */
+    void paintAggregated(QPainter *painter, const QRectF& exposed, qreal pixelsPerTile) {
+        int level = 0;
+        while (level + 1 < static_cast<int>(levels.size()) && (1 << level) * pixelsPerTile < 1.0) ++level;
+        qreal blockSize = static_cast<qreal>(tileSize) * (1 << level);
+        int levelRows = level == 0 ? rows : levels[level].rows;
+        int levelCols = level == 0 ? cols : levels[level].cols;
+        int firstRow = std::max(0, static_cast<int>(exposed.top() / blockSize));
+        int lastRow = std::min(levelRows - 1, static_cast<int>(exposed.bottom() / blockSize));
+        int firstCol = std::max(0, static_cast<int>(exposed.left() / blockSize));
+        int lastCol = std::min(levelCols - 1, static_cast<int>(exposed.right() / blockSize));
+        if (firstRow > lastRow || firstCol > lastCol) return;
+
+        int width = lastCol - firstCol + 1;
+        int height = lastRow - firstRow + 1;
+        if (blockImage.width() < width || blockImage.height() < height) {
+            blockImage = QImage(std::max(width, blockImage.width()), std::max(height, blockImage.height()), QImage::Format_RGB32);
+        }
+        const QColor free = tileColor(FreeTile);
+        const QColor obstacle = tileColor(ObstacleTile);
+        for (int row = firstRow; row <= lastRow; ++row) {
+            QRgb* line = reinterpret_cast<QRgb*>(blockImage.scanLine(row - firstRow));
+            for (int col = firstCol; col <= lastCol; ++col) {
+                QRgb& pixel = line[col - firstCol];
+                if (level == 0) {
+                    std::uint8_t cell = cells[static_cast<std::size_t>(row) * cols + col];
+                    pixel = (cell & OCCUPIED) ? qRgb(255, 255, 255) : tileColor(cell & KIND_MASK).rgb();
+                    continue;
+                }
+                const BlockLevel& blocks = levels[level];
+                std::size_t block = static_cast<std::size_t>(row) * blocks.cols + col;
+                if (blocks.occupied[block] > 0) {
+                    pixel = qRgb(255, 255, 255);
+                    continue;
+                }
+                // Celdas reales del bloque (los del borde derecho y de abajo pueden quedar cortados)
+                int blockRows = std::min(rows, (row + 1) << level) - (row << level);
+                int blockCols = std::min(cols, (col + 1) << level) - (col << level);
+                double total = static_cast<double>(blockRows) * blockCols;
+                double obstacleShare = blocks.obstacles[block] / total;
+                double freeShare = 1.0 - obstacleShare - blocks.hud[block] / total; // El negro no suma color
+                pixel = qRgb(static_cast<int>(free.red() * freeShare + obstacle.red() * obstacleShare),
+                             static_cast<int>(free.green() * freeShare + obstacle.green() * obstacleShare),
+                             static_cast<int>(free.blue() * freeShare + obstacle.blue() * obstacleShare));
+            }
+        }
+        painter->save();
+        painter->setClipRect(boundingRect(), Qt::IntersectClip); // Los bloques del borde pasan del mapa
+        painter->setRenderHint(QPainter::SmoothPixmapTransform, false);
+        painter->drawImage(QRectF(firstCol * blockSize, firstRow * blockSize, width * blockSize, height * blockSize),
+                           blockImage, QRectF(0, 0, width, height));
+        painter->restore();
+    }
+
+    // Las mismas celdas que dibujaba drawGrid con un QGraphicsRectItem cada una
+    void buildTiles() {
+        auto makeTile = [this](const QColor& fill, bool border) {
+            QPixmap tile(tileSize, tileSize);
+            tile.fill(fill);
+            if (border) {
+                QPainter painter(&tile);
+                painter.setPen(QPen(Qt::black));
+                painter.drawRect(0, 0, tileSize - 1, tileSize - 1);
+            }
+            return tile;
+        };
+        tiles[FreeTile] = makeTile(QColor(210, 180, 140), true);
+        tiles[ObstacleTile] = makeTile(QColor(139, 115, 85), true);
+        tiles[HudTile] = makeTile(Qt::black, false);
+    }
+};
+
+#endif // TILELAYERITEM_H
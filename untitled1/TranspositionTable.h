@@ -0,0 +1,107 @@
+#ifndef TRANSPOSITIONTABLE_H
+#define TRANSPOSITIONTABLE_H
+
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include "GameState.h"
+
+// Qué dice el puntaje guardado: exacto, cota inferior (hubo poda) o cota superior (ninguna jugada superó alfa)
+enum class BoundType : std::uint8_t { None, Exact, Lower, Upper };
+
+struct TableEntry {
+    int score = 0;
+    int depth = 0;
+    BoundType bound = BoundType::None;
+    bool hasMove = false;
+    AiMove move;
+};
+
+/*
+ * Tabla de transposición de tamaño fijo (potencia de 2) indexada por el hash de la posición.
+ * Cada casilla son dos palabras atómicas: los datos empaquetados y (clave XOR datos). Al leer se
+ * comprueba que clave XOR datos coincida; si dos hilos escribieron la casilla a la vez la
+ * comprobación falla y la lectura cuenta como fallo, sin locks. Se reemplaza siempre.
+ *
+ * Datos: puntaje (24 bits con signo), profundidad (8), tipo de cota (2) y mejor jugada (30:
+ * tipo, tanque, proyectil, fila y columna de hasta 1023; si no entra, se guarda sin jugada).
+ */
+class TranspositionTable {
+public:
+    static const int DEFAULT_SIZE_LOG2 = 18; // 2^18 casillas de 16 bytes = 4 MB
+
+    explicit TranspositionTable(int sizeLog2 = DEFAULT_SIZE_LOG2)
+        : mask((std::size_t(1) << sizeLog2) - 1), slots(new Slot[std::size_t(1) << sizeLog2]) {
+        clear();
+    }
+
+    void clear() {
+        for (std::size_t i = 0; i <= mask; ++i) {
+            slots[i].check.store(0, std::memory_order_relaxed);
+            slots[i].data.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    bool probe(std::uint64_t key, TableEntry& out) const {
+        const Slot& slot = slots[key & mask];
+        std::uint64_t data = slot.data.load(std::memory_order_relaxed);
+        std::uint64_t check = slot.check.load(std::memory_order_relaxed);
+        if (data == 0 || (check ^ data) != key) return false;
+        unpack(data, out);
+        return true;
+    }
+
+    void store(std::uint64_t key, const TableEntry& entry) {
+        Slot& slot = slots[key & mask];
+        std::uint64_t data = pack(entry);
+        slot.data.store(data, std::memory_order_relaxed);
+        slot.check.store(key ^ data, std::memory_order_relaxed);
+    }
+
+    std::size_t size() const { return mask + 1; }
+
+private:
+    struct Slot {
+        std::atomic<std::uint64_t> check;
+        std::atomic<std::uint64_t> data;
+    };
+
+    static const int MOVE_COORD_LIMIT = 1 << 10;
+
+    std::size_t mask;
+    std::unique_ptr<Slot[]> slots;
+
+    static std::uint64_t pack(const TableEntry& entry) {
+        std::uint64_t data = static_cast<std::uint64_t>(entry.score & 0xFFFFFF);
+        data |= static_cast<std::uint64_t>(entry.depth & 0xFF) << 24;
+        data |= static_cast<std::uint64_t>(entry.bound) << 32;
+        const AiMove& move = entry.move;
+        if (entry.hasMove && move.row >= 0 && move.row < MOVE_COORD_LIMIT && move.col >= 0 && move.col < MOVE_COORD_LIMIT) {
+            std::uint64_t packed = 1; // Hay jugada
+            packed |= static_cast<std::uint64_t>(move.kind) << 1;
+            packed |= static_cast<std::uint64_t>(move.tank & 0xF) << 3;
+            packed |= static_cast<std::uint64_t>(move.projectile) << 7;
+            packed |= static_cast<std::uint64_t>(move.row) << 9;
+            packed |= static_cast<std::uint64_t>(move.col) << 19;
+            data |= packed << 34;
+        }
+        return data;
+    }
+
+    static void unpack(std::uint64_t data, TableEntry& out) {
+        std::int32_t score = static_cast<std::int32_t>(data & 0xFFFFFF);
+        out.score = (score ^ 0x800000) - 0x800000; // Extender el signo de 24 bits
+        out.depth = static_cast<int>((data >> 24) & 0xFF);
+        out.bound = static_cast<BoundType>((data >> 32) & 0x3);
+        std::uint64_t packed = data >> 34;
+        out.hasMove = packed & 1;
+        out.move.kind = static_cast<AiMoveKind>((packed >> 1) & 0x3);
+        out.move.tank = static_cast<std::uint8_t>((packed >> 3) & 0xF);
+        out.move.projectile = static_cast<ProjectileType>((packed >> 7) & 0x3);
+        out.move.row = static_cast<std::int16_t>((packed >> 9) & 0x3FF);
+        out.move.col = static_cast<std::int16_t>((packed >> 19) & 0x3FF);
+    }
+};
+
+#endif // TRANSPOSITIONTABLE_H
@@ -0,0 +1,339 @@
+#ifndef VISIBILITY_H
+#define VISIBILITY_H
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <bit>
+#include <QPoint>
+#include "Graph.h"
+
+/*
+ * Celdas visibles desde una celda, guardadas como bits dentro de su rectángulo envolvente
+ * (fila por fila, cada fila alineada a palabras de 64 bits). En un mapa con obstáculos lo que
+ * se ve suele ser mucho menos que el mapa completo, así que la máscara ocupa poco.
+ */
+struct VisibilityMask {
+    int minRow = 0;
+    int minCol = 0;
+    int maxRow = -1; // maxRow < minRow: no se ve nada
+    int maxCol = -1;
+    int wordsPerRow = 0;
+    std::vector<std::uint64_t> words;
+    // Rectángulo de las celdas que miró el cálculo: solo un obstáculo ahí adentro puede cambiar la máscara
+    int scannedMinRow = 0;
+    int scannedMinCol = 0;
+    int scannedMaxRow = -1;
+    int scannedMaxCol = -1;
+
+    bool contains(int row, int col) const {
+        if (row < minRow || row > maxRow || col < minCol || col > maxCol) return false;
+        int bit = col - minCol;
+        return (words[static_cast<std::size_t>(row - minRow) * wordsPerRow + bit / 64] >> (bit % 64)) & 1u;
+    }
+
+    bool mayDependOn(int row, int col) const {
+        return row >= scannedMinRow && row <= scannedMaxRow && col >= scannedMinCol && col <= scannedMaxCol;
+    }
+
+    int count() const {
+        int total = 0;
+        for (std::uint64_t word : words) total += std::popcount(word);
+        return total;
+    }
+};
+
+/*
+ * Campo de visión de cada celda, calculado con shadowcasting simétrico (si A ve a B, B ve a A)
+ * la primera vez que se pide y guardado hasta que cambie un obstáculo cercano. Con el registro de
+ * cambios del mapa solo se descartan las máscaras cuyo cálculo miró una zona que incluye la celda
+ * modificada; los cambios de ocupación (tanques) no afectan la visión. Para no revisar todas las
+ * máscaras en cada cambio, cada una se anota en las regiones de REGION_SIZE x REGION_SIZE celdas
+ * que toca su rectángulo explorado, y un cambio solo mira la lista de su región.
+ *
+ * Los obstáculos se ven (y tapan lo que está detrás); el borde del mapa se trata como un muro.
+ * Con radius > 0 la visión se corta a esa distancia en filas o columnas.
+ */
+class VisibilityCache {
+public:
+    explicit VisibilityCache(int radius = 0) : radius(radius) {}
+
+    // Ponerse al día con el mapa; las consultas lo hacen solas
+    void syncWithMap(const Map& gameMap) {
+        if (gameMap.getNumRows() != rows || gameMap.getNumCols() != cols) {
+            reset(gameMap);
+            return;
+        }
+        if (gameMap.getVersion() == syncedVersion) return;
+        changed.clear();
+        if (!gameMap.changesSince(syncedVersion, changed)) {
+            reset(gameMap);
+            return;
+        }
+        for (const QPoint& at : changed) {
+            int index = at.x() * cols + at.y();
+            std::uint8_t isBlocked = gameMap.isObstacle(at.x(), at.y()) ? 1 : 0;
+            if (blocked[index] == isBlocked) continue; // Solo cambió la ocupación
+            blocked[index] = isBlocked;
+            invalidateAround(at.x(), at.y());
+        }
+        syncedVersion = gameMap.getVersion();
+    }
+
+    // Máscara de lo que se ve desde (row, col); la celda tiene que estar dentro del mapa
+    const VisibilityMask& visibleFrom(const Map& gameMap, int row, int col) {
+        syncWithMap(gameMap);
+        int index = row * cols + col;
+        if (!valid[index]) {
+            compute(row, col, masks[index]);
+            valid[index] = 1;
+            ++stamps[index];
+            addToRegions(index);
+            ++computed;
+        }
+        return masks[index];
+    }
+
+    bool canSee(const Map& gameMap, int fromRow, int fromCol, int toRow, int toCol) {
+        if (!gameMap.isValidIndex(fromRow, fromCol) || !gameMap.isValidIndex(toRow, toCol)) return false;
+        return visibleFrom(gameMap, fromRow, fromCol).contains(toRow, toCol);
+    }
+
+    /*
+     * Celdas visibles como bits del mapa completo: fila por fila, bitmapWordsPerRow() palabras
+     * por fila, la columna c en el bit c % 64 de la palabra c / 64.
+     */
+    void visibleBitmap(const Map& gameMap, int row, int col, std::vector<std::uint64_t>& out) {
+        syncWithMap(gameMap);
+        out.assign(static_cast<std::size_t>(rows) * bitmapWordsPerRow(), 0);
+        if (!gameMap.isValidIndex(row, col)) return;
+        const VisibilityMask& mask = visibleFrom(gameMap, row, col);
+        int shift = mask.minCol % 64;
+        int firstWord = mask.minCol / 64;
+        int outWords = bitmapWordsPerRow();
+        for (int r = mask.minRow; r <= mask.maxRow; ++r) {
+            const std::uint64_t* src = &mask.words[static_cast<std::size_t>(r - mask.minRow) * mask.wordsPerRow];
+            std::uint64_t* dst = &out[static_cast<std::size_t>(r) * outWords];
+            for (int w = 0; w < mask.wordsPerRow; ++w) {
+                dst[firstWord + w] |= src[w] << shift;
+                if (shift != 0 && firstWord + w + 1 < outWords) dst[firstWord + w + 1] |= src[w] >> (64 - shift);
+            }
+        }
+    }
+
+    void visibleCells(const Map& gameMap, int row, int col, std::vector<QPoint>& out) {
+        out.clear();
+        if (!gameMap.isValidIndex(row, col)) return;
+        const VisibilityMask& mask = visibleFrom(gameMap, row, col);
+        for (int r = mask.minRow; r <= mask.maxRow; ++r) {
+            for (int c = mask.minCol; c <= mask.maxCol; ++c) {
+                if (mask.contains(r, c)) out.push_back({r, c});
+            }
+        }
+    }
+
+    int bitmapWordsPerRow() const { return (cols + 63) / 64; }
+
+    void clear() {
+        rows = cols = -1;
+        masks.clear();
+        valid.clear();
+        blocked.clear();
+        stamps.clear();
+        regionMasks.clear();
+    }
+
+    // Cuántas máscaras se calcularon y cuántas se descartaron por cambios de obstáculos
+    long long getComputed() const { return computed; }
+    long long getInvalidated() const { return invalidated; }
+
+private:
+    // Fila del shadowcasting dentro de un cuadrante; las pendientes son fracciones num / den con den > 0
+    struct ScanRow {
+        int depth;
+        int startNum, startDen;
+        int endNum, endDen;
+    };
+
+    // Anotación de una máscara en una región; vieja si la máscara se descartó o se volvió a calcular
+    struct RegionEntry {
+        int index;
+        std::uint32_t stamp;
+    };
+
+    static constexpr int REGION_SIZE = 16;
+
+    int radius;
+    int rows = -1;
+    int cols = -1;
+    std::uint64_t syncedVersion = 0;
+    std::vector<VisibilityMask> masks;
+    std::vector<std::uint8_t> valid;
+    std::vector<std::uint8_t> blocked; // Copia de los obstáculos, para ignorar cambios de ocupación
+    std::vector<std::uint32_t> stamps; // Cuántas veces se calculó cada máscara
+    std::vector<std::vector<RegionEntry>> regionMasks; // Por región: máscaras que miraron alguna de sus celdas
+    int regionCols = 0;
+    std::vector<QPoint> changed;
+    std::vector<ScanRow> stack;
+    std::vector<std::uint64_t> scratch; // Bits del mapa completo mientras se calcula una máscara
+    long long computed = 0;
+    long long invalidated = 0;
+
+    void reset(const Map& gameMap) {
+        rows = gameMap.getNumRows();
+        cols = gameMap.getNumCols();
+        std::size_t cells = static_cast<std::size_t>(rows) * cols;
+        masks.assign(cells, VisibilityMask());
+        valid.assign(cells, 0);
+        blocked.assign(cells, 0);
+        stamps.assign(cells, 0);
+        regionCols = (cols + REGION_SIZE - 1) / REGION_SIZE;
+        regionMasks.assign(static_cast<std::size_t>((rows + REGION_SIZE - 1) / REGION_SIZE) * regionCols, {});
+        for (int r = 0; r < rows; ++r) {
+            for (int c = 0; c < cols; ++c) {
+                blocked[static_cast<std::size_t>(r) * cols + c] = gameMap.isObstacle(r, c) ? 1 : 0;
+            }
+        }
+        syncedVersion = gameMap.getVersion();
+    }
+
+    bool isCurrent(const RegionEntry& entry) const {
+        return valid[entry.index] && stamps[entry.index] == entry.stamp;
+    }
+
+    // Quitar de la lista las anotaciones viejas
+    void compact(std::vector<RegionEntry>& entries) const {
+        entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                     [this](const RegionEntry& entry) { return !isCurrent(entry); }),
+                      entries.end());
+    }
+
+    void addToRegions(int index) {
+        const VisibilityMask& mask = masks[index];
+        for (int r = mask.scannedMinRow / REGION_SIZE; r <= mask.scannedMaxRow / REGION_SIZE; ++r) {
+            for (int c = mask.scannedMinCol / REGION_SIZE; c <= mask.scannedMaxCol / REGION_SIZE; ++c) {
+                std::vector<RegionEntry>& entries = regionMasks[static_cast<std::size_t>(r) * regionCols + c];
+                // Antes de que la lista crezca se limpian las viejas, así no se acumulan sin límite
+                if (entries.size() == entries.capacity()) compact(entries);
+                entries.push_back({index, stamps[index]});
+            }
+        }
+    }
+
+    void invalidateAround(int row, int col) {
+        std::vector<RegionEntry>& entries = regionMasks[static_cast<std::size_t>(row / REGION_SIZE) * regionCols + col / REGION_SIZE];
+        std::size_t kept = 0;
+        for (const RegionEntry& entry : entries) {
+            if (!isCurrent(entry)) continue;
+            if (masks[entry.index].mayDependOn(row, col)) {
+                valid[entry.index] = 0;
+                ++invalidated;
+                continue;
+            }
+            entries[kept++] = entry;
+        }
+        entries.resize(kept);
+    }
+
+    bool isBlocking(int row, int col) const {
+        return row < 0 || row >= rows || col < 0 || col >= cols || blocked[static_cast<std::size_t>(row) * cols + col];
+    }
+
+    // floor(a / b) y ceil(a / b) con b > 0
+    static int floorDiv(int a, int b) { return a >= 0 ? a / b : -((-a + b - 1) / b); }
+    static int ceilDiv(int a, int b) { return -floorDiv(-a, b); }
+
+    // Celda en el cuadrante `quadrant` (0 arriba, 1 abajo, 2 derecha, 3 izquierda) a `depth` del origen
+    static void transform(int quadrant, int originRow, int originCol, int depth, int offset, int& row, int& col) {
+        switch (quadrant) {
+            case 0: row = originRow - depth; col = originCol + offset; break;
+            case 1: row = originRow + depth; col = originCol + offset; break;
+            case 2: row = originRow + offset; col = originCol + depth; break;
+            default: row = originRow + offset; col = originCol - depth; break;
+        }
+    }
+
+    // Shadowcasting simétrico por cuadrantes, sin recursión; deja el resultado comprimido en `mask`
+    void compute(int originRow, int originCol, VisibilityMask& mask) {
+        int outWords = bitmapWordsPerRow();
+        scratch.assign(static_cast<std::size_t>(rows) * outWords, 0);
+        int minRow = originRow, maxRow = originRow, minCol = originCol, maxCol = originCol;
+        int scannedMinRow = originRow, scannedMaxRow = originRow, scannedMinCol = originCol, scannedMaxCol = originCol;
+        auto reveal = [&](int r, int c) {
+            if (r < 0 || r >= rows || c < 0 || c >= cols) return;
+            scratch[static_cast<std::size_t>(r) * outWords + c / 64] |= std::uint64_t(1) << (c % 64);
+            minRow = std::min(minRow, r);
+            maxRow = std::max(maxRow, r);
+            minCol = std::min(minCol, c);
+            maxCol = std::max(maxCol, c);
+        };
+        reveal(originRow, originCol);
+
+        for (int quadrant = 0; quadrant < 4; ++quadrant) {
+            stack.clear();
+            stack.push_back({1, -1, 1, 1, 1});
+            while (!stack.empty()) {
+                ScanRow scan = stack.back();
+                stack.pop_back();
+                if (radius > 0 && scan.depth > radius) continue;
+                // Columnas de la fila: depth * start redondeado hacia arriba, depth * end hacia abajo (empates hacia adentro)
+                int minOffset = floorDiv(2 * scan.depth * scan.startNum + scan.startDen, 2 * scan.startDen);
+                int maxOffset = ceilDiv(2 * scan.depth * scan.endNum - scan.endDen, 2 * scan.endDen);
+                int prev = -1; // -1 sin celda anterior, 0 libre, 1 muro
+                for (int offset = minOffset; offset <= maxOffset; ++offset) {
+                    int r, c;
+                    transform(quadrant, originRow, originCol, scan.depth, offset, r, c);
+                    int wall = isBlocking(r, c) ? 1 : 0;
+                    if (r >= 0 && r < rows && c >= 0 && c < cols) {
+                        scannedMinRow = std::min(scannedMinRow, r);
+                        scannedMaxRow = std::max(scannedMaxRow, r);
+                        scannedMinCol = std::min(scannedMinCol, c);
+                        scannedMaxCol = std::max(scannedMaxCol, c);
+                    }
+                    // Simétrico: el centro de la celda tiene que estar dentro del sector
+                    bool symmetric = offset * scan.startDen >= scan.depth * scan.startNum
+                                     && offset * scan.endDen <= scan.depth * scan.endNum;
+                    if (wall || symmetric) reveal(r, c);
+                    if (prev == 1 && !wall) {
+                        scan.startNum = 2 * offset - 1;
+                        scan.startDen = 2 * scan.depth;
+                    }
+                    if (prev == 0 && wall) {
+                        stack.push_back({scan.depth + 1, scan.startNum, scan.startDen, 2 * offset - 1, 2 * scan.depth});
+                    }
+                    prev = wall;
+                }
+                if (prev == 0) {
+                    stack.push_back({scan.depth + 1, scan.startNum, scan.startDen, scan.endNum, scan.endDen});
+                }
+            }
+        }
+
+        // Copiar el rectángulo envolvente con la primera columna alineada al bit 0
+        mask.minRow = minRow;
+        mask.maxRow = maxRow;
+        mask.minCol = minCol;
+        mask.maxCol = maxCol;
+        mask.scannedMinRow = scannedMinRow;
+        mask.scannedMaxRow = scannedMaxRow;
+        mask.scannedMinCol = scannedMinCol;
+        mask.scannedMaxCol = scannedMaxCol;
+        mask.wordsPerRow = (maxCol - minCol + 1 + 63) / 64;
+        mask.words.assign(static_cast<std::size_t>(maxRow - minRow + 1) * mask.wordsPerRow, 0);
+        int shift = minCol % 64;
+        int firstWord = minCol / 64;
+        for (int r = minRow; r <= maxRow; ++r) {
+            const std::uint64_t* src = &scratch[static_cast<std::size_t>(r) * outWords];
+            std::uint64_t* dst = &mask.words[static_cast<std::size_t>(r - minRow) * mask.wordsPerRow];
+            for (int w = 0; w < mask.wordsPerRow; ++w) {
+                std::uint64_t word = src[firstWord + w] >> shift;
+                if (shift != 0 && firstWord + w + 1 < outWords) word |= src[firstWord + w + 1] << (64 - shift);
+                dst[w] = word;
+            }
+            int lastBits = (maxCol - minCol + 1) % 64;
+            if (lastBits != 0) dst[mask.wordsPerRow - 1] &= (std::uint64_t(1) << lastBits) - 1;
+        }
+    }
+};
+
+#endif // VISIBILITY_H
@@ -0,0 +1,68 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include "Rng.h"
+
+/*
+ * Claves de Zobrist para identificar una posición con un número de 64 bits: una clave al azar por
+ * (tanque, celda), por (tanque, vida) y por jugador que mueve; el hash es el XOR de las claves de
+ * la posición. Mover un tanque, quitarle vida o pasar el turno cambia el hash con dos o tres XOR,
+ * sin recorrer nada. Los obstáculos tienen su propia clave por celda para distinguir mapas.
+ *
+ * Las claves salen de una semilla fija, así que dos objetos del mismo tamaño de mapa dan los mismos
+ * hashes (la simulación y las búsquedas pueden comparar los suyos). Las de celda no se guardan:
+ * se calculan mezclando (splitmix64) el índice de la celda y el tanque, así que el objeto ocupa lo
+ * mismo en un mapa de 15 x 18 que en uno de 4096 x 4096.
+ */
+class ZobristKeys {
+public:
+    static const int MAX_TANKS = 16;
+    static const int HEALTH_LEVELS = 256; // Vidas de 0 a 255; más arriba comparten clave
+
+    explicit ZobristKeys(int numRows = 0, int numCols = 0) : rows(numRows), cols(numCols) {
+        Rng rng(SEED);
+        healths.resize(static_cast<std::size_t>(MAX_TANKS) * HEALTH_LEVELS);
+        for (std::uint64_t& key : healths) key = rng.next();
+        side = rng.next();
+        positionBase = rng.next();
+        obstacleBase = rng.next();
+    }
+
+    bool fits(int numRows, int numCols) const { return rows == numRows && cols == numCols; }
+
+    std::uint64_t position(int tank, int row, int col) const {
+        return mix(positionBase + (static_cast<std::uint64_t>(row) * cols + col) * MAX_TANKS + tank);
+    }
+
+    std::uint64_t health(int tank, int value) const {
+        return healths[static_cast<std::size_t>(tank) * HEALTH_LEVELS + std::clamp(value, 0, HEALTH_LEVELS - 1)];
+    }
+
+    std::uint64_t obstacle(int row, int col) const { return mix(obstacleBase + static_cast<std::uint64_t>(row) * cols + col); }
+
+    // Se suma (XOR) cuando mueve el jugador 2
+    std::uint64_t sideToMove() const { return side; }
+
+private:
+    static const std::uint64_t SEED = 0x5A0B1257ULL;
+
+    int rows;
+    int cols;
+    std::vector<std::uint64_t> healths;
+    std::uint64_t side;
+    std::uint64_t positionBase;
+    std::uint64_t obstacleBase;
+
+    // Finalizador de splitmix64: entradas consecutivas dan claves sin relación entre sí
+    static std::uint64_t mix(std::uint64_t z) {
+        z *= 0x9E3779B97F4A7C15ULL;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+};
+
+#endif // ZOBRIST_H
@@ -0,0 +1,282 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstdint>
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include "GameSimulation.h"
+
+/*
+ * Corre muchas partidas IA contra IA en paralelo para ajustar las políticas de movimiento.
+ * Cada hilo juega partidas completas con su propio GameSimulation; lo único compartido es el
+ * contador de la siguiente partida, y los resultados se suman al final.
+ *
+ * Uso: untitled1_batch [--matches N] [--threads T] [--seed S] [--max-turns M]
+ *                      [--bfs-percent P] [--astar-percent P] [--blue-algorithm A] [--red-algorithm A]
+ *                      [--search-player J] [--search-ms MS]
+ *                      [--search-ai alphabeta|mcts] [--search-threads T] [--mcts-parallel tree|root]
+ *                      [--map-rows R] [--map-cols C] [--map-pattern P] [--map-density D]
+ * La partida i usa la semilla S + i, sin importar qué hilo la juegue.
+ * --blue-algorithm y --red-algorithm (bfs, astar, hpa o dstar) cambian el algoritmo de azules/celestes
+ * (por defecto BFS, con --bfs-percent) y de rojos/amarillos (por defecto A*, con --astar-percent).
+ * D* Lite (dstar) trata a los tanques como paredes, así que no mueve igual que los demás.
+ * Con --search-player 0 o 1 ese jugador decide con una búsqueda (alfa-beta o MCTS, MS
+ * milisegundos por turno) y el otro sigue con el jugador automático de siempre. MCTS usa
+ * --search-threads hilos por búsqueda, además de los hilos de las partidas.
+ * --map-rows y --map-cols cambian el tamaño del mapa (por defecto el del juego) y --map-pattern
+ * (scattered, rooms o maze) con --map-density (porcentaje de obstáculos) el generador de MapGenerator.
+ */
+
+struct BatchOptions {
+    int matches = 10000;
+    int threads = 0; // 0 = todos los núcleos
+    std::uint64_t seed = 1;
+    int maxTurns = GameSimulation::DEFAULT_MAX_TURNS;
+    int bfsPercent = 50;   // Azules y celestes: BFS o movimiento aleatorio
+    int astarPercent = 80; // Rojos y amarillos: su algoritmo (--red-algorithm) o movimiento aleatorio
+    PathAlgorithm blueAlgorithm = PathAlgorithm::Bfs;
+    PathAlgorithm redAlgorithm = PathAlgorithm::AStar;
+    int searchPlayer = -1; // Jugador que usa la búsqueda, o -1
+    int searchMs = 20;
+    bool searchMcts = false;
+    int searchThreads = 1;
+    MctsAi::Parallelism mctsParallelism = MctsAi::Parallelism::Tree;
+    int mapRows = Map::DEFAULT_ROWS;
+    int mapCols = Map::DEFAULT_COLS;
+    MapGenOptions map = GameSimulation::defaultMapOptions(); // El seed de la partida reemplaza map.seed
+};
+
+struct BatchResult {
+    long long matches = 0;
+    long long wins[GameSimulation::NUM_PLAYERS] = {0, 0};
+    long long draws = 0;
+    long long turns = 0;
+    long long astarExpanded = 0;
+    long long searchTurns = 0;
+    long long searchNodes = 0; // Nodos de alfa-beta o simulaciones de MCTS
+    long long searchDepth = 0;
+    long long searchTableHits = 0;
+    double searchSeconds = 0.0;
+    MoveStats moves;
+
+    void add(const BatchResult& other) {
+        matches += other.matches;
+        for (int i = 0; i < GameSimulation::NUM_PLAYERS; ++i) wins[i] += other.wins[i];
+        draws += other.draws;
+        turns += other.turns;
+        astarExpanded += other.astarExpanded;
+        searchTurns += other.searchTurns;
+        searchNodes += other.searchNodes;
+        searchDepth += other.searchDepth;
+        searchTableHits += other.searchTableHits;
+        searchSeconds += other.searchSeconds;
+        moves.add(other.moves);
+    }
+};
+
+static const char* const ALGORITHM_NAMES[PATH_ALGORITHM_COUNT] = {"bfs", "astar", "hpa", "dstar"};
+static const char* const ALGORITHM_LABELS[PATH_ALGORITHM_COUNT] = {"BFS", "A*", "HPA*", "D* Lite"};
+
+static bool parseAlgorithm(const std::string& value, PathAlgorithm& algorithm) {
+    for (int i = 0; i < PATH_ALGORITHM_COUNT; ++i) {
+        if (value == ALGORITHM_NAMES[i]) {
+            algorithm = static_cast<PathAlgorithm>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+static const char* const PATTERN_NAMES[] = {"scattered", "rooms", "maze"};
+
+static bool parsePattern(const std::string& value, MapPattern& pattern) {
+    for (int i = 0; i < 3; ++i) {
+        if (value == PATTERN_NAMES[i]) {
+            pattern = static_cast<MapPattern>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool parseOptions(int argc, char *argv[], BatchOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) return false;
+        const char* value = argv[++i];
+        if (arg == "--matches") options.matches = std::atoi(value);
+        else if (arg == "--threads") options.threads = std::atoi(value);
+        else if (arg == "--seed") options.seed = std::strtoull(value, nullptr, 10);
+        else if (arg == "--max-turns") options.maxTurns = std::atoi(value);
+        else if (arg == "--bfs-percent") options.bfsPercent = std::atoi(value);
+        else if (arg == "--astar-percent") options.astarPercent = std::atoi(value);
+        else if (arg == "--blue-algorithm" && parseAlgorithm(value, options.blueAlgorithm)) {}
+        else if (arg == "--red-algorithm" && parseAlgorithm(value, options.redAlgorithm)) {}
+        else if (arg == "--search-player") options.searchPlayer = std::atoi(value);
+        else if (arg == "--search-ms") options.searchMs = std::atoi(value);
+        else if (arg == "--search-threads") options.searchThreads = std::atoi(value);
+        else if (arg == "--map-rows") options.mapRows = std::atoi(value);
+        else if (arg == "--map-cols") options.mapCols = std::atoi(value);
+        else if (arg == "--map-density") options.map.density = std::atoi(value);
+        else if (arg == "--map-pattern" && parsePattern(value, options.map.pattern)) {}
+        else if (arg == "--search-ai" && (std::string(value) == "alphabeta" || std::string(value) == "mcts")) {
+            options.searchMcts = std::string(value) == "mcts";
+        } else if (arg == "--mcts-parallel" && (std::string(value) == "tree" || std::string(value) == "root")) {
+            options.mctsParallelism = std::string(value) == "root" ? MctsAi::Parallelism::Root : MctsAi::Parallelism::Tree;
+        }
+        else return false;
+    }
+    return options.matches > 0 && options.threads >= 0 && options.maxTurns > 0
+           && options.searchPlayer >= -1 && options.searchPlayer < GameSimulation::NUM_PLAYERS && options.searchMs > 0 && options.searchThreads >= 0
+           && options.bfsPercent >= 0 && options.bfsPercent <= 100
+           && options.astarPercent >= 0 && options.astarPercent <= 100
+           && options.mapRows >= 4 && options.mapCols >= 4 && options.map.density >= 0 && options.map.density <= 90;
+}
+
+/*
+ * Una partida. `alphaBeta` es el del hilo (nulo si nadie busca con alfa-beta): se vacía antes de
+ * cada partida en vez de crearlo de nuevo, porque su tabla de 4 MB cuesta más que una partida.
+ * MCTS no guarda nada caro y se crea por partida con la semilla de la partida.
+ */
+static void playMatch(const BatchOptions& options, std::uint64_t seed, AlphaBetaAi* alphaBeta, BatchResult& result) {
+    GameSimulation simulation(seed, options.mapRows, options.mapCols);
+    simulation.setMapOptions(options.map);
+    simulation.setPolicy(TankColor::Blue, {options.blueAlgorithm, options.bfsPercent});
+    simulation.setPolicy(TankColor::Cyan, {options.blueAlgorithm, options.bfsPercent});
+    simulation.setPolicy(TankColor::Red, {options.redAlgorithm, options.astarPercent});
+    simulation.setPolicy(TankColor::Yellow, {options.redAlgorithm, options.astarPercent});
+    simulation.setMaxTurns(options.maxTurns);
+    simulation.setup();
+    if (alphaBeta) alphaBeta->clearTable();
+    std::optional<MctsAi> mcts;
+    if (options.searchPlayer >= 0 && options.searchMcts) {
+        MctsAi::Options mctsOptions;
+        mctsOptions.timeBudgetMs = options.searchMs;
+        mctsOptions.threads = options.searchThreads;
+        mctsOptions.parallelism = options.mctsParallelism;
+        mctsOptions.seed = seed;
+        mcts.emplace(mctsOptions);
+    }
+    while (!simulation.isGameOver()) {
+        if (simulation.getCurrentPlayer() == options.searchPlayer) {
+            ++result.searchTurns;
+            if (mcts) {
+                MctsAi::Result search = simulation.playSearchTurn(*mcts);
+                result.searchNodes += search.rollouts;
+                result.searchSeconds += search.seconds;
+            } else {
+                AlphaBetaAi::Result search = simulation.playSearchTurn(*alphaBeta);
+                result.searchNodes += search.nodes;
+                result.searchDepth += search.depth;
+                result.searchTableHits += search.tableHits;
+                result.searchSeconds += search.seconds;
+            }
+        } else {
+            simulation.playRandomTurn();
+        }
+    }
+
+    ++result.matches;
+    result.turns += simulation.getTurn();
+    if (simulation.getWinner() < 0) {
+        ++result.draws;
+    } else {
+        ++result.wins[simulation.getWinner()];
+    }
+    result.moves.add(simulation.getMoveStats());
+}
+
+static double percent(long long part, long long total) {
+    return total > 0 ? 100.0 * static_cast<double>(part) / static_cast<double>(total) : 0.0;
+}
+
+static double average(long long sum, long long count) {
+    return count > 0 ? static_cast<double>(sum) / static_cast<double>(count) : 0.0;
+}
+
+int main(int argc, char *argv[]) {
+    BatchOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "Uso: " << argv[0] << " [--matches N] [--threads T] [--seed S] [--max-turns M]"
+                  << " [--bfs-percent P] [--astar-percent P] [--blue-algorithm bfs|astar|hpa|dstar]"
+                  << " [--red-algorithm bfs|astar|hpa|dstar] [--search-player J] [--search-ms MS]"
+                  << " [--search-ai alphabeta|mcts] [--search-threads T] [--mcts-parallel tree|root]"
+                  << " [--map-rows R] [--map-cols C] [--map-pattern scattered|rooms|maze] [--map-density D]" << std::endl;
+        return 1;
+    }
+    int numThreads = options.threads > 0 ? options.threads : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    numThreads = std::min(numThreads, options.matches);
+
+    std::atomic<int> nextMatch{0};
+    std::vector<BatchResult> results(numThreads); // Uno por hilo: no se comparte nada mientras se juega
+    std::vector<std::thread> workers;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < numThreads; ++t) {
+        workers.emplace_back([&options, &nextMatch, &results, t]() {
+            BatchResult local;
+            std::unique_ptr<AlphaBetaAi> alphaBeta;
+            if (options.searchPlayer >= 0 && !options.searchMcts) {
+                AlphaBetaAi::Options alphaBetaOptions;
+                alphaBetaOptions.timeBudgetMs = options.searchMs;
+                alphaBeta = std::make_unique<AlphaBetaAi>(alphaBetaOptions);
+            }
+            long long expandedBefore = Pathfinding::stats().astarExpanded; // Contadores por hilo
+            for (int i = nextMatch.fetch_add(1); i < options.matches; i = nextMatch.fetch_add(1)) {
+                playMatch(options, options.seed + static_cast<std::uint64_t>(i), alphaBeta.get(), local);
+            }
+            local.astarExpanded = Pathfinding::stats().astarExpanded - expandedBefore;
+            results[t] = local;
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    BatchResult total;
+    for (const BatchResult& result : results) {
+        total.add(result);
+    }
+
+    const int astar = static_cast<int>(PathAlgorithm::AStar);
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Partidas: " << total.matches << " con " << numThreads << " hilos en " << seconds << " s ("
+              << (seconds > 0 ? total.matches / seconds : 0.0) << " partidas/s)" << std::endl;
+    std::cout << "Políticas: azules " << ALGORITHM_LABELS[static_cast<int>(options.blueAlgorithm)] << " " << options.bfsPercent
+              << "%, rojos " << ALGORITHM_LABELS[static_cast<int>(options.redAlgorithm)] << " " << options.astarPercent << "%" << std::endl;
+    std::cout << "Mapa: " << options.mapRows << " x " << options.mapCols << ", " << PATTERN_NAMES[static_cast<int>(options.map.pattern)]
+              << " " << options.map.density << "%" << std::endl;
+    std::cout << "Player 1 (rojo/azul): " << percent(total.wins[0], total.matches) << "%  "
+              << "Player 2 (amarillo/celeste): " << percent(total.wins[1], total.matches) << "%  "
+              << "Empates: " << percent(total.draws, total.matches) << "%" << std::endl;
+    std::cout << "Turnos por partida: " << average(total.turns, total.matches) << std::endl;
+    for (int algorithm = 0; algorithm < PATH_ALGORITHM_COUNT; ++algorithm) {
+        long long moves = total.moves.pathMoves[algorithm];
+        if (moves == 0) continue;
+        std::cout << ALGORITHM_LABELS[algorithm] << ": " << moves << " caminos, largo medio "
+                  << average(total.moves.pathSteps[algorithm], moves - total.moves.unreachable[algorithm])
+                  << ", sin camino " << percent(total.moves.unreachable[algorithm], moves) << "%";
+        if (algorithm == astar) std::cout << ", nodos expandidos por búsqueda " << average(total.astarExpanded, moves);
+        std::cout << std::endl;
+    }
+    std::cout << "Movimientos aleatorios: " << total.moves.randomMoves << std::endl;
+    if (total.searchTurns > 0 && options.searchMcts) {
+        std::cout << "MCTS (player " << options.searchPlayer + 1 << "): " << total.searchTurns << " turnos, "
+                  << average(total.searchNodes, total.searchTurns) << " simulaciones por turno, "
+                  << (total.searchSeconds > 0 ? total.searchNodes / total.searchSeconds : 0.0) << " simulaciones/s" << std::endl;
+    } else if (total.searchTurns > 0) {
+        std::cout << "Alfa-beta (player " << options.searchPlayer + 1 << "): " << total.searchTurns << " turnos, profundidad media "
+                  << average(total.searchDepth, total.searchTurns) << ", "
+                  << (total.searchSeconds > 0 ? total.searchNodes / total.searchSeconds : 0.0) << " nodos/s, "
+                  << percent(total.searchTableHits, total.searchNodes) << "% resueltos con la tabla" << std::endl;
+    }
+    std::cout << "Disparos: " << total.moves.shots << ", aciertos " << percent(total.moves.shotHits, total.moves.shots) << "%" << std::endl;
+    return 0;
+}
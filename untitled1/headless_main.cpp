@@ -0,0 +1,44 @@
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <cstdint>
+#include "GameSimulation.h"
+
+/*
+ * Partidas sin ventana: no se crea QApplication ni escena, solo GameSimulation.
+ * Uso: untitled1_headless [partidas] [semilla]
+ */
+int main(int argc, char *argv[]) {
+    int matches = argc > 1 ? std::atoi(argv[1]) : 1000;
+    std::uint64_t seed = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1;
+    if (matches <= 0) {
+        std::cerr << "Uso: " << argv[0] << " [partidas] [semilla]" << std::endl;
+        return 1;
+    }
+
+    int wins[GameSimulation::NUM_PLAYERS] = {0, 0};
+    int draws = 0;
+    long long turns = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < matches; ++i) {
+        GameSimulation simulation(seed + i);
+        simulation.setup();
+        while (!simulation.isGameOver()) {
+            simulation.playRandomTurn();
+        }
+        turns += simulation.getTurn();
+        if (simulation.getWinner() < 0) {
+            ++draws;
+        } else {
+            ++wins[simulation.getWinner()];
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Partidas: " << matches << " en " << seconds << " s ("
+              << (seconds > 0 ? matches / seconds : 0) << " partidas/s)" << std::endl;
+    std::cout << "Player 1: " << wins[0] << "  Player 2: " << wins[1] << "  Empates: " << draws << std::endl;
+    std::cout << "Turnos promedio: " << static_cast<double>(turns) / matches << std::endl;
+    return 0;
+}
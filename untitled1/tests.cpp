@@ -0,0 +1,722 @@
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+#include <cstdint>
+#include <algorithm>
+#include "Graph.h"
+#include "Rng.h"
+#include "Pathfinding.h"
+#include "Bitboard.h"
+#include "JumpPointSearch.h"
+#include "HierarchicalPathfinding.h"
+#include "IncrementalPathfinding.h"
+#include "FlowField.h"
+#include "DistanceOracle.h"
+#include "MapGenerator.h"
+#include "TranspositionTable.h"
+#include "Visibility.h"
+#include "Ballistics.h"
+#include "TankRegistry.h"
+#include "Zobrist.h"
+#include "GameState.h"
+#include "AlphaBetaAi.h"
+#include "MctsAi.h"
+#include "GameSimulation.h"
+
+/*
+ * Pruebas sin framework: cada comprobación que falla se imprime y el programa termina con 1.
+ * Uso: untitled1_tests (ctest lo corre con add_test)
+ */
+
+static int failures = 0;
+
+static void check(bool condition, const char* what, int row = -1, int col = -1, int toRow = -1, int toCol = -1) {
+    if (condition) return;
+    ++failures;
+    std::cerr << "FALLA: " << what;
+    if (row >= 0) std::cerr << " (" << row << "," << col << ") -> (" << toRow << "," << toCol << ")";
+    std::cerr << std::endl;
+}
+
+static const MapPattern PATTERNS[] = {MapPattern::Scattered, MapPattern::Rooms, MapPattern::Maze};
+
+static Map seededMap(int rows, int cols, MapPattern pattern, int density, std::uint64_t seed) {
+    MapGenOptions options;
+    options.pattern = pattern;
+    options.density = density;
+    options.seed = seed;
+    return MapGenerator::create(rows, cols, options);
+}
+
+static QPoint randomFreeCell(const Map& gameMap, Rng& rng) {
+    while (true) {
+        int row = rng.bounded(0, gameMap.getNumRows());
+        int col = rng.bounded(0, gameMap.getNumCols());
+        if (!gameMap.isObstacle(row, col)) return {row, col};
+    }
+}
+
+// Camino válido: empieza y termina donde debe, pasos de una celda y sin obstáculos
+static bool isValidPath(const Map& gameMap, const std::vector<QPoint>& path, QPoint from, QPoint to) {
+    if (path.empty() || path.front() != from || path.back() != to) return false;
+    for (std::size_t k = 0; k < path.size(); ++k) {
+        if (!gameMap.isValidIndex(path[k].x(), path[k].y()) || gameMap.isObstacle(path[k].x(), path[k].y())) return false;
+        if (k > 0 && std::abs(path[k].x() - path[k - 1].x()) + std::abs(path[k].y() - path[k - 1].y()) != 1) return false;
+    }
+    return true;
+}
+
+// Los caminos más cortos tienen el largo de bfsPath; HPA* encuentra camino si BFS lo encuentra, no más corto
+static void testPathfinders() {
+    Rng rng(12345);
+    for (int m = 0; m < 24; ++m) {
+        int rows = rng.bounded(6, 61);
+        int cols = rng.bounded(6, 61);
+        Map gameMap = seededMap(rows, cols, PATTERNS[m % 3], rng.bounded(0, 41), 100 + m);
+        // Paredes sueltas para que también haya celdas sin camino
+        for (int k = 0; k < rows * cols / 20; ++k) {
+            QPoint cell = randomFreeCell(gameMap, rng);
+            gameMap.setObstacle(cell.x(), cell.y());
+        }
+
+        MapBitboard board(gameMap);
+        JumpPointTable table(gameMap);
+        HierarchicalPathfinder hierarchical(8);
+        hierarchical.build(gameMap);
+        IncrementalPlanner planner;
+        DistanceOracle exact;
+        exact.build(gameMap);
+        DistanceOracle landmarks;
+        landmarks.build(gameMap, 0, 4);
+
+        for (int q = 0; q < 40; ++q) {
+            QPoint from = randomFreeCell(gameMap, rng);
+            QPoint to = randomFreeCell(gameMap, rng);
+            int r0 = from.x(), c0 = from.y(), r1 = to.x(), c1 = to.y();
+            std::vector<QPoint> reference = Pathfinding::bfsPath(gameMap, r0, c0, r1, c1);
+            bool reachable = !reference.empty();
+            check(!reachable || isValidPath(gameMap, reference, from, to), "bfsPath inválido", r0, c0, r1, c1);
+
+            auto sameLength = [&](const std::vector<QPoint>& path, const char* name) {
+                check(path.size() == reference.size(), name, r0, c0, r1, c1);
+                check(!reachable || isValidPath(gameMap, path, from, to), name, r0, c0, r1, c1);
+            };
+            sameLength(Pathfinding::dijkstraPath(gameMap, r0, c0, r1, c1), "dijkstraPath: largo distinto de BFS");
+            sameLength(Pathfinding::astarPath(gameMap, r0, c0, r1, c1), "astarPath: largo distinto de BFS");
+            sameLength(Pathfinding::astarPath(gameMap, exact, r0, c0, r1, c1), "astarPath (tabla exacta): largo distinto de BFS");
+            sameLength(Pathfinding::astarPath(gameMap, landmarks, r0, c0, r1, c1), "astarPath (ALT): largo distinto de BFS");
+            sameLength(Pathfinding::jpsPath(gameMap, r0, c0, r1, c1), "jpsPath: largo distinto de BFS");
+            sameLength(Pathfinding::jpsPlusPath(table, gameMap, r0, c0, r1, c1), "jpsPlusPath: largo distinto de BFS");
+            sameLength(Pathfinding::bitboardBfsPath(board, r0, c0, r1, c1), "bitboardBfsPath: largo distinto de BFS");
+            sameLength(planner.plan(gameMap, q % 4, r0, c0, r1, c1), "D* Lite: largo distinto de BFS");
+
+            std::vector<QPoint> abstractPath = hierarchical.findPath(gameMap, r0, c0, r1, c1);
+            check(abstractPath.empty() == !reachable, "HPA*: encuentra camino distinto de BFS", r0, c0, r1, c1);
+            check(!reachable || (isValidPath(gameMap, abstractPath, from, to) && abstractPath.size() >= reference.size()),
+                  "HPA*: camino inválido o más corto que BFS", r0, c0, r1, c1);
+
+            int distance = reachable ? static_cast<int>(reference.size()) - 1 : -1;
+            check(exact.getMode() != DistanceOracle::Mode::Exact || exact.distance(r0, c0, r1, c1) == distance,
+                  "DistanceOracle: distancia exacta distinta de BFS", r0, c0, r1, c1);
+            check(!reachable || landmarks.lowerBound(r0, c0, r1, c1) <= distance, "DistanceOracle: cota ALT mayor que BFS", r0, c0, r1, c1);
+        }
+    }
+}
+
+// JPS+ después de poner y quitar obstáculos: la tabla refrescada es la misma que una nueva
+static void testJumpPointTable() {
+    Rng rng(777);
+    for (int m = 0; m < 6; ++m) {
+        int rows = rng.bounded(8, 41);
+        int cols = rng.bounded(8, 41);
+        Map gameMap = seededMap(rows, cols, PATTERNS[m % 3], 20, 300 + m);
+        JumpPointTable table(gameMap);
+        for (int round = 0; round < 30; ++round) {
+            int row = rng.bounded(0, rows - 2);
+            int col = rng.bounded(0, cols);
+            if (gameMap.isObstacle(row, col)) {
+                gameMap.clearObstacle(row, col);
+            } else {
+                gameMap.setObstacle(row, col);
+            }
+
+            table.refresh(gameMap);
+            JumpPointTable fresh(gameMap);
+            bool same = true;
+            for (int i = 0; i < rows; ++i) {
+                for (int j = 0; j < cols; ++j) {
+                    for (int dir = 0; dir < 4; ++dir) {
+                        same = same && table.get(i, j, dir) == fresh.get(i, j, dir);
+                    }
+                }
+            }
+            check(same, "JumpPointTable: refresh distinto de una tabla nueva", row, col);
+
+            QPoint from = randomFreeCell(gameMap, rng);
+            QPoint to = randomFreeCell(gameMap, rng);
+            std::vector<QPoint> reference = Pathfinding::bfsPath(gameMap, from.x(), from.y(), to.x(), to.y());
+            std::vector<QPoint> path = Pathfinding::jpsPlusPath(table, gameMap, from.x(), from.y(), to.x(), to.y());
+            check(path.size() == reference.size() && (reference.empty() || isValidPath(gameMap, path, from, to)),
+                  "jpsPlusPath después de cambiar obstáculos: largo distinto de BFS", from.x(), from.y(), to.x(), to.y());
+        }
+    }
+
+    // Más columnas que las que entran en 16 bits: sin tabla, el resultado es el de jpsPath
+    Map wide(4, JumpPointTable::MAX_SIDE + 10);
+    int lastCol = wide.getNumCols() - 1;
+    wide.setObstacle(0, lastCol - 1); // El único giro hacia (0, lastCol) queda a más de 32767 celdas
+    JumpPointTable table(wide);
+    check(!table.isAvailable(), "JumpPointTable: tabla armada para un mapa demasiado ancho");
+    std::vector<QPoint> reference = Pathfinding::bfsPath(wide, 1, 0, 0, lastCol);
+    std::vector<QPoint> path = Pathfinding::jpsPlusPath(table, wide, 1, 0, 0, lastCol);
+    check(path.size() == reference.size() && isValidPath(wide, path, {1, 0}, {0, lastCol}),
+          "jpsPlusPath en mapa ancho: largo distinto de BFS", 1, 0, 0, lastCol);
+}
+
+// HPA* después de poner y quitar obstáculos: solo se rehacen los clusters vecinos y da lo mismo que uno nuevo
+static void testHierarchicalRepair() {
+    Rng rng(6060);
+    for (int m = 0; m < 6; ++m) {
+        int rows = rng.bounded(20, 61);
+        int cols = rng.bounded(20, 61);
+        Map gameMap = seededMap(rows, cols, PATTERNS[m % 3], 25, 600 + m);
+        HierarchicalPathfinder hierarchical(8);
+        hierarchical.build(gameMap);
+        for (int round = 0; round < 25; ++round) {
+            int row = rng.bounded(0, rows - 2);
+            int col = rng.bounded(0, cols);
+            if (gameMap.isObstacle(row, col)) {
+                gameMap.clearObstacle(row, col);
+            } else {
+                gameMap.setObstacle(row, col);
+            }
+            long long rebuiltBefore = hierarchical.getRebuiltClusters();
+            hierarchical.refresh(gameMap);
+            check(hierarchical.getRebuiltClusters() - rebuiltBefore <= 5, "HPA*: un cambio rehízo más que el cluster y sus vecinos", row, col);
+
+            HierarchicalPathfinder fresh(8);
+            fresh.build(gameMap);
+            for (int q = 0; q < 10; ++q) {
+                QPoint from = randomFreeCell(gameMap, rng);
+                QPoint to = randomFreeCell(gameMap, rng);
+                int r0 = from.x(), c0 = from.y(), r1 = to.x(), c1 = to.y();
+                std::vector<QPoint> reference = Pathfinding::bfsPath(gameMap, r0, c0, r1, c1);
+                std::vector<QPoint> path = hierarchical.findPath(gameMap, r0, c0, r1, c1);
+                check(path.size() == fresh.findPath(gameMap, r0, c0, r1, c1).size(),
+                      "HPA* reparado: camino distinto del de uno construido de cero", r0, c0, r1, c1);
+                check(path.empty() == reference.empty(), "HPA* reparado: encuentra camino distinto de BFS", r0, c0, r1, c1);
+                check(reference.empty() || (isValidPath(gameMap, path, from, to) && path.size() >= reference.size()),
+                      "HPA* reparado: camino inválido o más corto que BFS", r0, c0, r1, c1);
+            }
+        }
+    }
+}
+
+// Largo del camino mínimo en pasos si las celdas con tanque también bloquean (salvo inicio y destino); -1 si no hay
+static int occupiedAwareDistance(const Map& gameMap, QPoint from, QPoint to) {
+    int cols = gameMap.getNumCols();
+    std::vector<int> distance(static_cast<std::size_t>(gameMap.getNumRows()) * cols, -1);
+    std::vector<QPoint> queue{from};
+    distance[from.x() * cols + from.y()] = 0;
+    for (std::size_t head = 0; head < queue.size(); ++head) {
+        QPoint at = queue[head];
+        if (at == to) return distance[at.x() * cols + at.y()];
+        const int dRow[4] = {0, 1, 0, -1};
+        const int dCol[4] = {1, 0, -1, 0};
+        for (int dir = 0; dir < 4; ++dir) {
+            QPoint next(at.x() + dRow[dir], at.y() + dCol[dir]);
+            if (!gameMap.isValidIndex(next.x(), next.y()) || distance[next.x() * cols + next.y()] >= 0) continue;
+            if (next != to && gameMap.isOccupied(next.x(), next.y())) continue;
+            distance[next.x() * cols + next.y()] = distance[at.x() * cols + at.y()] + 1;
+            queue.push_back(next);
+        }
+    }
+    return -1;
+}
+
+// D* Lite reparando el plan mientras el tanque avanza y cambian obstáculos y tanques: sigue siendo mínimo
+static void testIncrementalRepair() {
+    Rng rng(7070);
+    for (int m = 0; m < 8; ++m) {
+        int rows = rng.bounded(12, 41);
+        int cols = rng.bounded(12, 41);
+        Map gameMap = seededMap(rows, cols, PATTERNS[m % 3], 20, 800 + m);
+        IncrementalPlanner planner;
+        QPoint at = randomFreeCell(gameMap, rng);
+        QPoint goal = randomFreeCell(gameMap, rng);
+        std::vector<QPoint> tanks;
+        for (int round = 0; round < 60 && at != goal; ++round) {
+            for (int change = 0; change < 4; ++change) {
+                QPoint cell(rng.bounded(0, rows - 2), rng.bounded(0, cols));
+                if (cell == at || cell == goal) continue;
+                if (gameMap.isObstacle(cell.x(), cell.y())) {
+                    gameMap.clearObstacle(cell.x(), cell.y());
+                } else if (rng.bounded(2) == 0) {
+                    gameMap.setObstacle(cell.x(), cell.y());
+                } else if (!gameMap.isOccupied(cell.x(), cell.y())) {
+                    gameMap.addEdge(cell.x(), cell.y());
+                    tanks.push_back(cell);
+                }
+            }
+            if (!tanks.empty() && rng.bounded(3) == 0) {
+                gameMap.removeEdge(tanks.back().x(), tanks.back().y());
+                tanks.pop_back();
+            }
+
+            std::vector<QPoint> path = planner.plan(gameMap, 0, at.x(), at.y(), goal.x(), goal.y());
+            int expected = occupiedAwareDistance(gameMap, at, goal);
+            check(static_cast<int>(path.size()) - 1 == expected, "D* Lite reparado: largo distinto de BFS con tanques", at.x(), at.y(), goal.x(), goal.y());
+            check(path.empty() || isValidPath(gameMap, path, at, goal), "D* Lite reparado: camino inválido", at.x(), at.y(), goal.x(), goal.y());
+            if (path.size() > 1 && round % 3 == 0) at = path[1];
+        }
+    }
+}
+
+// Campos de flujo: mismo largo que BFS, varios objetivos dan la distancia al más cercano y se rehacen solo con obstáculos nuevos
+static void testFlowField() {
+    Rng rng(9191);
+    for (int m = 0; m < 8; ++m) {
+        int rows = rng.bounded(8, 41);
+        int cols = rng.bounded(8, 41);
+        Map gameMap = seededMap(rows, cols, PATTERNS[m % 3], rng.bounded(0, 36), 900 + m);
+        FlowFieldCache cache(4);
+        std::vector<QPoint> targets;
+        for (int k = 0; k < 6; ++k) targets.push_back(randomFreeCell(gameMap, rng));
+
+        for (int round = 0; round < 6; ++round) {
+            for (int q = 0; q < 30; ++q) {
+                QPoint from = randomFreeCell(gameMap, rng);
+                QPoint to = targets[rng.bounded(0, static_cast<int>(targets.size()))];
+                int r0 = from.x(), c0 = from.y(), r1 = to.x(), c1 = to.y();
+                if (gameMap.isObstacle(r1, c1)) continue;
+                std::vector<QPoint> reference = Pathfinding::bfsPath(gameMap, r0, c0, r1, c1);
+                std::vector<QPoint> path = cache.path(gameMap, r0, c0, r1, c1);
+                check(path.size() == reference.size(), "FlowFieldCache: largo distinto de BFS", r0, c0, r1, c1);
+                check(reference.empty() || isValidPath(gameMap, path, from, to), "FlowFieldCache: camino inválido", r0, c0, r1, c1);
+            }
+
+            // Un tanque no cambia el campo; un obstáculo sí
+            const QPoint& target = targets[0];
+            cache.get(gameMap, target.x(), target.y());
+            long long builds = cache.getBuilds();
+            QPoint tank = randomFreeCell(gameMap, rng);
+            gameMap.addEdge(tank.x(), tank.y());
+            cache.get(gameMap, target.x(), target.y());
+            check(cache.getBuilds() == builds, "FlowFieldCache: se rehízo un campo por un cambio de ocupación", tank.x(), tank.y());
+            gameMap.removeEdge(tank.x(), tank.y());
+            QPoint wall = randomFreeCell(gameMap, rng);
+            gameMap.setObstacle(wall.x(), wall.y());
+            cache.get(gameMap, target.x(), target.y());
+            check(cache.getBuilds() == builds + 1, "FlowFieldCache: el campo no se rehízo con un obstáculo nuevo", wall.x(), wall.y());
+        }
+
+        // Varios objetivos: cada celda queda a la distancia BFS del objetivo más cercano
+        FlowField field;
+        field.build(gameMap, targets);
+        for (int q = 0; q < 30; ++q) {
+            QPoint from = randomFreeCell(gameMap, rng);
+            int nearest = FlowField::UNREACHED;
+            for (const QPoint& target : targets) {
+                if (gameMap.isObstacle(target.x(), target.y())) continue;
+                std::vector<QPoint> reference = Pathfinding::bfsPath(gameMap, from.x(), from.y(), target.x(), target.y());
+                int steps = static_cast<int>(reference.size()) - 1;
+                if (!reference.empty() && (nearest == FlowField::UNREACHED || steps < nearest)) nearest = steps;
+            }
+            check(field.distance(from.x(), from.y()) == nearest, "FlowField: distancia al objetivo más cercano distinta de BFS", from.x(), from.y());
+            std::vector<QPoint> path = field.pathFrom(from.x(), from.y());
+            check(static_cast<int>(path.size()) - 1 == nearest, "FlowField: camino al objetivo más cercano con largo distinto", from.x(), from.y());
+        }
+    }
+}
+
+static void testMapGenerator() {
+    for (MapPattern pattern : PATTERNS) {
+        for (int density : {0, 10, 25, 40, 60, 90}) {
+            for (std::uint64_t seed = 1; seed <= 4; ++seed) {
+                int rows = 5 + static_cast<int>(seed * 13 % 50);
+                int cols = 4 + static_cast<int>(seed * 29 % 60);
+                Map gameMap = seededMap(rows, cols, pattern, density, seed);
+                check(MapGenerator::disconnectedCells(gameMap) == 0, "MapGenerator: quedan celdas libres desconectadas", rows, cols);
+            }
+
+            // Varias franjas de filas: misma semilla, mismo mapa, y la densidad cerca de la pedida
+            const int rows = 203;
+            const int cols = 150;
+            Map gameMap = seededMap(rows, cols, pattern, density, 7);
+            Map again = seededMap(rows, cols, pattern, density, 7);
+            long long obstacles = 0;
+            bool same = true;
+            for (int i = 0; i < rows - 2; ++i) {
+                for (int j = 0; j < cols; ++j) {
+                    obstacles += gameMap.isObstacle(i, j) ? 1 : 0;
+                    same = same && gameMap.cellAt(i, j) == again.cellAt(i, j);
+                }
+            }
+            long long percent = obstacles * 100 / ((rows - 2) * cols);
+            check(same, "MapGenerator: la misma semilla dio mapas distintos", rows, cols);
+            check(MapGenerator::disconnectedCells(gameMap) == 0, "MapGenerator: quedan celdas libres desconectadas", rows, cols);
+            check(density > 40 || std::abs(percent - density) <= 5, "MapGenerator: densidad lejos de la pedida", rows, cols, density, static_cast<int>(percent));
+        }
+    }
+}
+
+static bool sameEntry(const TableEntry& a, const TableEntry& b) {
+    return a.score == b.score && a.depth == b.depth && a.bound == b.bound && a.hasMove == b.hasMove
+           && (!a.hasMove || a.move == b.move);
+}
+
+static void testTranspositionTable() {
+    TranspositionTable table(10);
+    Rng rng(777);
+    const BoundType bounds[] = {BoundType::Exact, BoundType::Lower, BoundType::Upper};
+    for (int k = 0; k < 5000; ++k) {
+        TableEntry entry;
+        entry.score = rng.bounded(-(1 << 23) + 1, 1 << 23);
+        entry.depth = rng.bounded(0, 256);
+        entry.bound = bounds[k % 3];
+        entry.hasMove = k % 4 != 0;
+        entry.move = {static_cast<AiMoveKind>(rng.bounded(0, 3)), static_cast<std::uint8_t>(rng.bounded(0, 16)),
+                      static_cast<std::int16_t>(rng.bounded(0, 1024)), static_cast<std::int16_t>(rng.bounded(0, 1024)),
+                      static_cast<ProjectileType>(rng.bounded(0, 3))};
+        std::uint64_t key = rng.next() | 1;
+        table.store(key, entry);
+        TableEntry out;
+        check(table.probe(key, out) && sameEntry(entry, out), "TranspositionTable: lo guardado no vuelve igual");
+        check(!table.probe(key ^ (std::uint64_t(1) << 40), out), "TranspositionTable: acierto con otra clave");
+    }
+
+    // Una jugada con coordenadas fuera de rango se guarda sin jugada
+    TableEntry far{42, 3, BoundType::Lower, true, {AiMoveKind::Move, 1, 2000, 5, ProjectileType::Standard}};
+    table.store(99, far);
+    TableEntry out;
+    check(table.probe(99, out) && !out.hasMove && out.score == 42 && out.depth == 3, "TranspositionTable: jugada fuera de rango");
+}
+
+// Shadowcasting simétrico: si A ve a B, B ve a A, con y sin radio
+static void testVisibilitySymmetry() {
+    Rng rng(4242);
+    for (int m = 0; m < 12; ++m) {
+        Map gameMap = seededMap(rng.bounded(6, 41), rng.bounded(6, 41), PATTERNS[m % 3], rng.bounded(0, 36), 500 + m);
+        VisibilityCache unlimited;
+        VisibilityCache limited(5);
+        for (int q = 0; q < 400; ++q) {
+            QPoint a = randomFreeCell(gameMap, rng);
+            QPoint b = randomFreeCell(gameMap, rng);
+            check(unlimited.canSee(gameMap, a.x(), a.y(), b.x(), b.y()) == unlimited.canSee(gameMap, b.x(), b.y(), a.x(), a.y()),
+                  "VisibilityCache: visión no simétrica", a.x(), a.y(), b.x(), b.y());
+            check(limited.canSee(gameMap, a.x(), a.y(), b.x(), b.y()) == limited.canSee(gameMap, b.x(), b.y(), a.x(), a.y()),
+                  "VisibilityCache (radio 5): visión no simétrica", a.x(), a.y(), b.x(), b.y());
+        }
+    }
+}
+
+// Después de poner y quitar obstáculos, las máscaras guardadas son las de una caché nueva
+static void testVisibilityInvalidation() {
+    Rng rng(9090);
+    std::vector<std::uint64_t> cached;
+    std::vector<std::uint64_t> expected;
+    for (int m = 0; m < 6; ++m) {
+        int rows = rng.bounded(20, 51);
+        int cols = rng.bounded(20, 51);
+        Map gameMap = seededMap(rows, cols, PATTERNS[m % 3], 20, 700 + m);
+        VisibilityCache cache(m % 2 == 0 ? 0 : 6);
+        for (int i = 0; i < rows; ++i) {
+            for (int j = 0; j < cols; ++j) cache.visibleFrom(gameMap, i, j);
+        }
+        for (int round = 0; round < 20; ++round) {
+            int row = rng.bounded(0, rows - 2);
+            int col = rng.bounded(0, cols);
+            if (gameMap.isObstacle(row, col)) {
+                gameMap.clearObstacle(row, col);
+            } else {
+                gameMap.setObstacle(row, col);
+            }
+
+            VisibilityCache fresh(m % 2 == 0 ? 0 : 6);
+            for (int q = 0; q < 60; ++q) {
+                int r = rng.bounded(0, rows);
+                int c = rng.bounded(0, cols);
+                cache.visibleBitmap(gameMap, r, c, cached);
+                fresh.visibleBitmap(gameMap, r, c, expected);
+                check(cached == expected, "VisibilityCache: máscara vieja después de cambiar un obstáculo", row, col, r, c);
+            }
+        }
+        check(cache.getInvalidated() > 0, "VisibilityCache: ningún cambio descartó máscaras");
+    }
+}
+
+// Disparos: el recorrido es continuo y respeta el tipo de proyectil; en paquete da lo mismo que de a uno
+static void testBallistics() {
+    Rng rng(1616);
+    const ProjectileType types[] = {ProjectileType::Standard, ProjectileType::Bouncing, ProjectileType::Piercing};
+    std::vector<QPoint> path;
+    std::vector<ShotResult> batch;
+    for (int m = 0; m < 8; ++m) {
+        int rows = rng.bounded(8, 41);
+        int cols = rng.bounded(8, 41);
+        Map gameMap = seededMap(rows, cols, PATTERNS[m % 3], rng.bounded(0, 36), 1600 + m);
+        std::vector<int> occupants(static_cast<std::size_t>(rows) * cols, -1);
+        for (int id = 0; id < 6; ++id) {
+            QPoint at = randomFreeCell(gameMap, rng);
+            occupants[at.x() * cols + at.y()] = id;
+        }
+
+        std::vector<Shot> shots;
+        for (int q = 0; q < 200; ++q) {
+            QPoint from = randomFreeCell(gameMap, rng);
+            Projectile projectile = Projectile::of(types[q % 3]);
+            shots.push_back({from.x(), from.y(), rng.bounded(0, rows), rng.bounded(0, cols), projectile, occupants[from.x() * cols + from.y()]});
+        }
+        Ballistics::traceBatch(gameMap, occupants.data(), shots, batch);
+
+        for (std::size_t k = 0; k < shots.size(); ++k) {
+            const Shot& shot = shots[k];
+            ShotResult result = Ballistics::trace(gameMap, occupants.data(), shot, &path);
+            const ShotResult& packed = batch[k];
+            check(packed.tankId == result.tankId && packed.row == result.row && packed.col == result.col && packed.cells == result.cells
+                  && packed.bounces == result.bounces && packed.penetrations == result.penetrations,
+                  "Ballistics: traceBatch distinto de trace", shot.row, shot.col, shot.targetRow, shot.targetCol);
+
+            bool continuous = path.size() == static_cast<std::size_t>(1 + result.cells + result.bounces)
+                              && path.back() == QPoint(result.row, result.col);
+            int walls = 0;
+            bool passedTank = false;
+            for (std::size_t i = 1; i < path.size(); ++i) {
+                int step = std::abs(path[i].x() - path[i - 1].x()) + std::abs(path[i].y() - path[i - 1].y());
+                continuous = continuous && step <= 1 && gameMap.isValidIndex(path[i].x(), path[i].y());
+                if (step == 0) continue;
+                walls += gameMap.isObstacle(path[i].x(), path[i].y()) ? 1 : 0;
+                int occupant = occupants[path[i].x() * cols + path[i].y()];
+                passedTank = passedTank || (i + 1 < path.size() && occupant >= 0 && occupant != shot.shooterId);
+            }
+            check(continuous, "Ballistics: recorrido con saltos o que no termina en el resultado", shot.row, shot.col, shot.targetRow, shot.targetCol);
+            check(result.cells + result.bounces <= shot.projectile.range, "Ballistics: recorrido más largo que el alcance", shot.row, shot.col, shot.targetRow, shot.targetCol);
+            check(result.bounces <= shot.projectile.bounces && result.penetrations <= shot.projectile.penetrations && walls == result.penetrations,
+                  "Ballistics: rebotes o perforaciones de más", shot.row, shot.col, shot.targetRow, shot.targetCol);
+            check(!passedTank, "Ballistics: el disparo atravesó un tanque", shot.row, shot.col, shot.targetRow, shot.targetCol);
+            check(!result.hit() || (occupants[result.row * cols + result.col] == result.tankId && result.tankId != shot.shooterId),
+                  "Ballistics: impacto en una celda sin ese tanque", shot.row, shot.col, shot.targetRow, shot.targetCol);
+        }
+    }
+
+    // Sin obstáculos en medio, un disparo normal alcanza al tanque de la celda objetivo
+    Map open(12, 12);
+    std::vector<int> occupants(12 * 12, -1);
+    occupants[2 * 12 + 9] = 3;
+    ShotResult result = Ballistics::trace(open, occupants.data(), {7, 1, 2, 9, Projectile::of(ProjectileType::Standard), -1});
+    check(result.tankId == 3 && result.row == 2 && result.col == 9, "Ballistics: no alcanza un tanque a la vista", 7, 1, 2, 9);
+    check(Ballistics::hasLineOfFire(open, 7, 1, 2, 9), "Ballistics: sin línea de fuego en un mapa vacío", 7, 1, 2, 9);
+}
+
+// El hash de Zobrist que se lleva al día (simulación y GameStateRules::apply) es el calculado desde cero
+static void testZobristHash() {
+    Rng rng(2020);
+    for (std::uint64_t seed = 1; seed <= 12; ++seed) {
+        GameSimulation simulation(seed, 15 + static_cast<int>(seed % 3) * 5, 18);
+        simulation.setup();
+        const Map& gameMap = simulation.getMap();
+        ZobristKeys keys(gameMap.getNumRows(), gameMap.getNumCols());
+        check(simulation.getHash() == simulation.snapshot().computeHash(keys), "Zobrist: hash de la simulación distinto al empezar");
+        while (!simulation.isGameOver() && simulation.getTurn() < 300) {
+            simulation.playRandomTurn();
+            check(simulation.getHash() == simulation.snapshot().computeHash(keys), "Zobrist: hash de la simulación distinto después de un turno",
+                  simulation.getTurn(), static_cast<int>(seed));
+        }
+
+        // Jugadas al azar de la búsqueda sobre una partida nueva con la misma semilla
+        GameSimulation fresh(seed, gameMap.getNumRows(), gameMap.getNumCols());
+        fresh.setup();
+        GameStateRules rules(fresh.getMap());
+        GameState state = fresh.snapshot();
+        rules.bind(state);
+        std::vector<AiMove> moves;
+        for (int ply = 0; ply < 200 && !state.isTerminal(); ++ply) {
+            rules.generate(state, moves);
+            rules.apply(state, moves[rng.bounded(0, static_cast<int>(moves.size()))]);
+            check(state.hash == state.computeHash(rules.getKeys()), "Zobrist: hash distinto después de GameStateRules::apply", ply, static_cast<int>(seed));
+        }
+    }
+}
+
+// GameStateRules::undo deja la ocupación como estaba, y la búsqueda alfa-beta juega jugadas posibles y gana si puede
+static void testAlphaBeta() {
+    Rng rng(1818);
+    std::vector<AiMove> moves, expected, actual;
+    for (std::uint64_t seed = 1; seed <= 6; ++seed) {
+        GameSimulation simulation(seed);
+        simulation.setup();
+        const Map& gameMap = simulation.getMap();
+        GameStateRules rules(gameMap);
+        GameState state = simulation.snapshot();
+        rules.bind(state);
+        for (int ply = 0; ply < 30 && !state.isTerminal(); ++ply) {
+            rules.generate(state, moves);
+            for (const AiMove& move : moves) {
+                GameState child = state;
+                rules.apply(child, move);
+                GameStateRules fresh(gameMap);
+                fresh.bind(child);
+                fresh.generate(child, expected);
+                rules.generate(child, actual);
+                check(actual == expected, "Reglas: jugadas distintas después de apply", ply, static_cast<int>(seed));
+                rules.undo(state, child);
+            }
+            GameStateRules fresh(gameMap);
+            fresh.bind(state);
+            fresh.generate(state, expected);
+            rules.generate(state, actual);
+            check(actual == expected, "Reglas: jugadas distintas después de undo", ply, static_cast<int>(seed));
+            rules.apply(state, moves[rng.bounded(0, static_cast<int>(moves.size()))]);
+        }
+
+        AlphaBetaAi::Options options;
+        options.maxDepth = 3;
+        options.timeBudgetMs = 5000;
+        AlphaBetaAi ai(options);
+        GameState root = simulation.snapshot();
+        AlphaBetaAi::Result result = ai.search(gameMap, root);
+        rules.bind(root);
+        rules.generate(root, moves);
+        check(std::find(moves.begin(), moves.end(), result.move) != moves.end(), "Alfa-beta: jugada que no está entre las posibles",
+              static_cast<int>(seed));
+    }
+
+    // Un solo enemigo con 1 de vida: si algún disparo lo mata, la búsqueda tiene que encontrar la victoria
+    int wins = 0;
+    for (std::uint64_t seed = 1; seed <= 30; ++seed) {
+        GameSimulation simulation(seed);
+        simulation.setup();
+        const Map& gameMap = simulation.getMap();
+        GameState root = simulation.snapshot();
+        bool kept = false;
+        for (int i = 0; i < root.numTanks; ++i) {
+            if (root.tanks[i].team != 1) continue;
+            root.tanks[i].health = static_cast<std::int16_t>(kept ? 0 : 1);
+            kept = true;
+        }
+        GameStateRules rules(gameMap);
+        root.hash = root.computeHash(rules.getKeys());
+        rules.bind(root);
+        rules.generate(root, moves);
+        bool winnable = false;
+        for (const AiMove& move : moves) {
+            GameState child = root;
+            rules.apply(child, move);
+            rules.undo(root, child);
+            winnable = winnable || child.aliveCount(1) == 0;
+        }
+        if (!winnable) continue;
+        ++wins;
+
+        AlphaBetaAi::Options options;
+        options.maxDepth = 4;
+        options.timeBudgetMs = 5000;
+        AlphaBetaAi ai(options);
+        AlphaBetaAi::Result result = ai.search(gameMap, root);
+        GameState after = root;
+        rules.apply(after, result.move);
+        check(after.aliveCount(1) == 0 && result.score >= AlphaBetaAi::WIN_SCORE - 64, "Alfa-beta: no encontró la victoria inmediata",
+              static_cast<int>(seed));
+    }
+    check(wins > 0, "Alfa-beta: ninguna posición de prueba con victoria inmediata");
+}
+
+// MCTS: con un tope de simulaciones y una semilla fija juega siempre la misma jugada posible, con uno o varios hilos
+static void testMcts() {
+    std::vector<AiMove> moves;
+    for (std::uint64_t seed = 1; seed <= 6; ++seed) {
+        GameSimulation simulation(seed);
+        simulation.setup();
+        const Map& gameMap = simulation.getMap();
+        GameState root = simulation.snapshot();
+        GameStateRules rules(gameMap);
+        rules.bind(root);
+        rules.generate(root, moves);
+
+        MctsAi::Options options;
+        options.maxRollouts = 1500;
+        options.timeBudgetMs = 60000;
+        options.seed = seed;
+        MctsAi::Result first = MctsAi(options).search(gameMap, root);
+        MctsAi::Result second = MctsAi(options).search(gameMap, root);
+        check(std::find(moves.begin(), moves.end(), first.move) != moves.end(), "MCTS: jugada que no está entre las posibles",
+              static_cast<int>(seed));
+        check(first.rollouts == options.maxRollouts, "MCTS: no respetó el tope de simulaciones", static_cast<int>(first.rollouts));
+        check(first.move == second.move && first.visits == second.visits, "MCTS: resultados distintos con la misma semilla",
+              static_cast<int>(seed));
+
+        for (MctsAi::Parallelism parallelism : {MctsAi::Parallelism::Tree, MctsAi::Parallelism::Root}) {
+            options.threads = 3;
+            options.parallelism = parallelism;
+            MctsAi::Result result = MctsAi(options).search(gameMap, root);
+            check(std::find(moves.begin(), moves.end(), result.move) != moves.end(), "MCTS: jugada que no está entre las posibles con varios hilos",
+                  static_cast<int>(seed), static_cast<int>(parallelism));
+        }
+    }
+}
+
+// Daño de área contra un recorrido tanque por tanque; los handles de otra partida dejan de valer
+static void testTankRegistry() {
+    Rng rng(31337);
+    for (int round = 0; round < 200; ++round) {
+        TankRegistry registry;
+        std::vector<int> rows, cols, health, teams;
+        int numTanks = rng.bounded(1, 40);
+        for (int i = 0; i < numTanks; ++i) {
+            rows.push_back(rng.bounded(0, 30));
+            cols.push_back(rng.bounded(0, 30));
+            teams.push_back(rng.bounded(0, 2));
+            health.push_back(rng.bounded(0, 4) == 0 ? 0 : 100);
+            registry.add(rows[i], cols[i], TankColor::Red, teams[i], 100);
+            if (health[i] == 0) registry.damage(static_cast<std::uint32_t>(i), 100);
+        }
+        int row = rng.bounded(0, 30), col = rng.bounded(0, 30), radius = rng.bounded(0, 10), amount = rng.bounded(1, 150);
+        std::vector<std::uint32_t> destroyed;
+        int hits = registry.applyAreaDamage(row, col, radius, amount, &destroyed);
+
+        int expectedHits = 0;
+        std::vector<std::uint32_t> expectedDestroyed;
+        for (int i = 0; i < numTanks; ++i) {
+            if (health[i] == 0 || std::abs(rows[i] - row) + std::abs(cols[i] - col) > radius) continue;
+            ++expectedHits;
+            health[i] = std::max(0, health[i] - amount);
+            if (health[i] == 0) expectedDestroyed.push_back(static_cast<std::uint32_t>(i));
+        }
+        check(hits == expectedHits && destroyed == expectedDestroyed, "TankRegistry: daño de área distinto del recorrido simple");
+        int alive[2] = {0, 0};
+        for (int i = 0; i < numTanks; ++i) {
+            check(registry.healthOf(static_cast<std::uint32_t>(i)) == health[i], "TankRegistry: vida distinta");
+            check(registry.ref(registry.handle(static_cast<std::uint32_t>(i))).getHealth() == health[i], "TankRef: vida distinta");
+            alive[teams[i]] += health[i] > 0;
+        }
+        check(registry.countAlive(0) == alive[0] && registry.countAlive(1) == alive[1], "TankRegistry: countAlive");
+
+        TankRef old = registry.ref(registry.handle(0));
+        registry.clear();
+        registry.add(1, 1, TankColor::Blue, 0, 100);
+        check(!old.isValid() && old.isDestroyed() && old.getHealth() == 0, "TankRef: el handle de otra partida sigue valiendo");
+    }
+}
+
+int main() {
+    testPathfinders();
+    testJumpPointTable();
+    testHierarchicalRepair();
+    testIncrementalRepair();
+    testFlowField();
+    testMapGenerator();
+    testTranspositionTable();
+    testVisibilitySymmetry();
+    testVisibilityInvalidation();
+    testBallistics();
+    testZobristHash();
+    testAlphaBeta();
+    testMcts();
+    testTankRegistry();
+    if (failures > 0) {
+        std::cerr << failures << " comprobaciones fallaron" << std::endl;
+        return 1;
+    }
+    std::cout << "Todas las pruebas pasaron" << std::endl;
+    return 0;
+}